@@ -0,0 +1,180 @@
+// Animation micro-benchmarks.
+//
+// 1) Keyframe lookup cost in sampleClip as clip length grows.
+// A synthetic rig whose every joint carries translation/rotation/scale tracks keyed at 120 Hz
+// (mocap density) is played forward at 60 fps, once with the context-free sampleClip (binary
+// search per channel) and once through an AnimEvalContext (cursor walk). The reported figure
+// is nanoseconds per channel per sample; the cursor column should stay flat as the clip grows.
+//
+// 2) Load-time cost of bakeClips, serial (WorkerPool capped to one thread) against the full
+// pool, for a rig shaped like models/monkey_bone_anim/monkeybone.glb (5 joints, 2 clips of
+// 2.5 s keyed at 24 Hz) and for a crowd-character rig (128 joints, 40 clips). Both bakes are
+// compared byte for byte.
+//
+// 3) Per-frame cost of runtime blending: a crowd of entities each crossfading between two clips,
+// evaluated (evaluateBlend -> resolveGlobals -> globalsToPalette) the way
+// Application::updateAnimationBlends does, serial against the full pool.
+
+#include "bench_common.hpp"
+#include "bagel_worker_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bench {
+
+	// Play `clip` forward end to end; returns ns per channel per sample.
+	static double playForward(const SkeletonData& skel, const AnimationClip& clip, AnimEvalContext* ctx)
+	{
+		const int samples = static_cast<int>(clip.duration * PLAY_RATE) + 1;
+		Pose pose;
+		float sink = 0.0f; // keeps the loop observable so it is not optimized away
+		const auto t0 = BenchClock::now();
+		for (int i = 0; i < samples; ++i)
+		{
+			const float t = static_cast<float>(i) / PLAY_RATE;
+			if (ctx) sampleClip(skel, clip, t, pose, *ctx);
+			else     sampleClip(skel, clip, t, pose);
+			sink += pose.back().translation.x;
+		}
+		const double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - t0).count();
+		if (sink == 12345.678f) std::printf(" ");
+		return ns / (static_cast<double>(samples) * clip.channels.size());
+	}
+
+	void benchLookup(Report& report)
+	{
+		const int joints = 64;
+		const SkeletonData skel = makeChain(joints);
+
+		std::printf("sampleClip keyframe lookup, %d joints x 3 channels, keys at %.0f Hz, played at %.0f fps\n",
+		            joints, KEY_RATE, PLAY_RATE);
+		std::printf("%10s %10s %18s %18s\n", "clip (s)", "keys", "search ns/chan", "cursor ns/chan");
+		for (float seconds : { 1.0f, 4.0f, 16.0f, 64.0f, 256.0f })
+		{
+			if (report.quick && seconds > 16.0f) break;
+			const AnimationClip clip = makeClip(joints, seconds);
+			AnimEvalContext ctx;
+			playForward(skel, clip, &ctx); // warm caches and the context
+			const double search = playForward(skel, clip, nullptr);
+			ctx = AnimEvalContext{};
+			const double cursor = playForward(skel, clip, &ctx);
+			std::printf("%10.0f %10zu %18.2f %18.2f\n", seconds, clip.samplers[0].times.size(), search, cursor);
+			report.add("lookup", "search", "clip_seconds", seconds, "ns/channel", search);
+			report.add("lookup", "cursor", "clip_seconds", seconds, "ns/channel", cursor);
+		}
+	}
+
+	// Best of `runs` bakes of `clips` at 60 fps with the pool capped to `threads` (0 = all); ms.
+	static double timeBake(const SkeletonData& skel, const std::vector<AnimationClip>& clips, uint32_t threads,
+	                       BakedAnimation& out, int runs = 5)
+	{
+		WorkerPool::get().setMaxThreads(threads);
+		double best = 1e30;
+		for (int r = 0; r < runs; ++r)
+		{
+			const auto t0 = BenchClock::now();
+			out = bakeClips(skel, clips, 60.0f);
+			best = std::min(best, std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count());
+		}
+		WorkerPool::get().setMaxThreads(0);
+		return best;
+	}
+
+	void benchBake(Report& report)
+	{
+		struct Rig { const char* name; int joints; int clips; float seconds; float keyRate; };
+		const Rig rigs[] = {
+			{ "monkeybone",  5,   2,  2.5f, 24.0f },
+			{ "crowd",       128, 40, 2.5f, 30.0f },
+			{ "crowd-long",  128, 40, 10.0f, 30.0f },
+		};
+
+		std::printf("\nbakeClips at 60 fps, WorkerPool threads: %u\n", WorkerPool::get().threadCount());
+		std::printf("%12s %7s %6s %8s %12s %12s %8s %10s\n",
+		            "rig", "joints", "clips", "rows", "serial ms", "pool ms", "speedup", "identical");
+		for (const Rig& rig : rigs)
+		{
+			if (report.quick && rig.seconds > 2.5f) continue;
+			const SkeletonData skel = makeChain(rig.joints);
+			std::vector<AnimationClip> clips;
+			for (int c = 0; c < rig.clips; ++c) clips.push_back(makeClip(rig.joints, rig.seconds, rig.keyRate));
+
+			BakedAnimation serial, pooled;
+			const int runs = report.quick ? 1 : 5;
+			const double s = timeBake(skel, clips, 1, serial, runs);
+			const double p = timeBake(skel, clips, 0, pooled, runs);
+			const bool same = serial.matrices.size() == pooled.matrices.size() &&
+				std::memcmp(serial.matrices.data(), pooled.matrices.data(), serial.matrices.size() * sizeof(PaletteMatrix)) == 0;
+			std::printf("%12s %7d %6d %8zu %12.3f %12.3f %7.2fx %10s\n", rig.name, rig.joints, rig.clips,
+			            serial.matrices.size() / rig.joints, s, p, s / p, same ? "yes" : "NO");
+			const std::string stage = std::string("bake_") + rig.name;
+			report.add("bake", (stage + "_serial").c_str(), "joints", rig.joints, "ms", s);
+			report.add("bake", (stage + "_pool").c_str(), "joints", rig.joints, "ms", p);
+		}
+	}
+
+	// One crossfading entity: two layers with their own cursors, and its palette block.
+	struct BlendEntity {
+		AnimEvalContext ctx[2];
+		float           time = 0.0f;
+	};
+
+	// Mean ms per frame over `frames` frames of evaluating every entity, pool capped to `threads`.
+	static double timeBlendFrames(const SkeletonData& skel, const std::vector<AnimationClip>& clips,
+	                              std::vector<BlendEntity>& ents, std::vector<BlendScratch>& scratch,
+	                              std::vector<PaletteMatrix>& palette, uint32_t threads, int frames = 120)
+	{
+		WorkerPool& pool = WorkerPool::get();
+		pool.setMaxThreads(threads);
+		const uint32_t joints = skel.jointCount();
+		const auto t0 = BenchClock::now();
+		for (int f = 0; f < frames; ++f)
+		{
+			pool.parallelFor(static_cast<uint32_t>(ents.size()), 4, [&](uint32_t begin, uint32_t end, uint32_t worker) {
+				BlendScratch& s = scratch[worker];
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					BlendEntity& e = ents[i];
+					e.time = std::fmod(e.time + 1.0f / PLAY_RATE, clips[0].duration);
+					const float w = 0.5f + 0.5f * std::sin(e.time);
+					const BlendInput inputs[2] = {
+						{ &clips[0], e.time, 1.0f - w, &e.ctx[0] },
+						{ &clips[1], e.time, w,        &e.ctx[1] },
+					};
+					evaluateBlend(skel, inputs, 2, s.pool, s.pose);
+					resolveGlobals(skel, s.pose, s.globals);
+					globalsToPalette(skel, s.globals, &palette[static_cast<size_t>(i) * joints]);
+				}
+			});
+		}
+		pool.setMaxThreads(0);
+		return std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count() / frames;
+	}
+
+	void benchBlend(Report& report)
+	{
+		const int joints = 64;
+		const SkeletonData skel = makeChain(joints);
+		const std::vector<AnimationClip> clips = { makeClip(joints, 2.5f, 30.0f), makeClip(joints, 2.5f, 30.0f) };
+		std::vector<BlendScratch> scratch(WorkerPool::get().threadCount());
+
+		std::printf("\nruntime crossfade (2 layers), %d joints, WorkerPool threads: %u\n", joints, WorkerPool::get().threadCount());
+		std::printf("%10s %16s %16s %8s\n", "entities", "serial ms/frame", "pool ms/frame", "speedup");
+		for (int count : { 16, 128, 1024 })
+		{
+			if (report.quick && count > 128) break;
+			std::vector<BlendEntity> ents(count);
+			for (int i = 0; i < count; ++i) ents[i].time = 0.01f * static_cast<float>(i);
+			std::vector<PaletteMatrix> palette(static_cast<size_t>(count) * joints);
+			const int frames = report.quick ? 8 : 120;
+			timeBlendFrames(skel, clips, ents, scratch, palette, 0, 4); // warm the pools and cursors
+			const double s = timeBlendFrames(skel, clips, ents, scratch, palette, 1, frames);
+			const double p = timeBlendFrames(skel, clips, ents, scratch, palette, 0, frames);
+			std::printf("%10d %16.3f %16.3f %7.2fx\n", count, s, p, s / p);
+			report.add("blend", "crossfade_serial", "entities", count, "ms/frame", s);
+			report.add("blend", "crossfade_pool", "entities", count, "ms/frame", p);
+		}
+	}
+
+} // namespace bench
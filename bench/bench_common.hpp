@@ -0,0 +1,193 @@
+#pragma once
+
+// Shared pieces of the BagelBench suites: synthetic rigs and clips, a calibrated timer, and the
+// report every suite appends its numbers to (printed as tables, optionally written as CSV/JSON).
+
+#include "animation/bagel_animation.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+	using namespace bagel;
+	using BenchClock = std::chrono::steady_clock;
+
+	inline constexpr float KEY_RATE  = 120.0f; // keys per second on every track
+	inline constexpr float PLAY_RATE = 60.0f;  // samples per second of playback
+
+	// Chain skeleton of `joints` joints, each parented to the previous one.
+	inline SkeletonData makeChain(int joints)
+	{
+		SkeletonData skel;
+		skel.restPose.resize(joints);
+		skel.inverseBind.assign(joints, glm::mat4(1.0f));
+		skel.parents.resize(joints);
+		skel.names.resize(joints);
+		for (int j = 0; j < joints; ++j)
+		{
+			skel.parents[j] = j - 1;
+			skel.restPose[j].translation = glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+		buildJointOrder(skel);
+		return skel;
+	}
+
+	// Character-shaped skeleton: a root with limbs of LIMB_LENGTH joints hanging off it, so the
+	// hierarchy is shallow and wide like a real rig, and every limb is a valid two-bone IK chain.
+	inline constexpr int LIMB_LENGTH = 4;
+
+	inline SkeletonData makeLimbRig(int joints)
+	{
+		SkeletonData skel;
+		skel.restPose.resize(joints);
+		skel.inverseBind.assign(joints, glm::mat4(1.0f));
+		skel.parents.resize(joints);
+		skel.names.resize(joints);
+		skel.parents[0] = -1;
+		for (int j = 1; j < joints; ++j)
+		{
+			const bool limbStart = (j - 1) % LIMB_LENGTH == 0;
+			skel.parents[j] = limbStart ? 0 : j - 1;
+			const float limb = static_cast<float>((j - 1) / LIMB_LENGTH);
+			skel.restPose[j].translation = limbStart ? glm::vec3(std::cos(limb), 0.0f, std::sin(limb))
+			                                         : glm::vec3(0.0f, -1.0f, 0.0f);
+		}
+		buildJointOrder(skel);
+		return skel;
+	}
+
+	// One clip of `seconds` length with a T/R/S channel per joint, each keyed at `keyRate`.
+	inline AnimationClip makeClip(int joints, float seconds, float keyRate = KEY_RATE)
+	{
+		AnimationClip clip;
+		clip.duration = seconds;
+		const int keys = static_cast<int>(seconds * keyRate) + 1;
+		for (int j = 0; j < joints; ++j)
+			for (int p = 0; p < 3; ++p)
+			{
+				AnimSampler s;
+				s.times.resize(keys);
+				s.values.resize(keys);
+				for (int k = 0; k < keys; ++k)
+				{
+					const float t = static_cast<float>(k) / keyRate;
+					s.times[k] = t;
+					const float a = std::sin(t * 3.0f + static_cast<float>(j));
+					if (p == 1) // rotation: unit quaternion about Z, stored xyzw
+						s.values[k] = glm::vec4(0.0f, 0.0f, std::sin(a * 0.5f), std::cos(a * 0.5f));
+					else
+						s.values[k] = glm::vec4(a, 1.0f + 0.1f * a, 0.0f, 0.0f);
+				}
+				AnimChannel ch;
+				ch.joint   = j;
+				ch.path    = static_cast<AnimPath>(p);
+				ch.sampler = static_cast<int>(clip.samplers.size());
+				clip.samplers.push_back(std::move(s));
+				clip.channels.push_back(ch);
+			}
+		return clip;
+	}
+
+	// Nanoseconds per call of `fn`: the iteration count doubles until one batch takes at least
+	// `minMs`, then the best of `reps` batches of that size is kept (least disturbed by the OS).
+	template <class Fn>
+	double nsPerCall(Fn&& fn, double minMs, int reps = 3)
+	{
+		fn(); // warm caches and any lazily grown scratch
+		uint64_t iters = 1;
+		for (;;)
+		{
+			const auto t0 = BenchClock::now();
+			for (uint64_t i = 0; i < iters; ++i) fn();
+			const double ms = std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count();
+			if (ms >= minMs || iters >= (1ull << 30)) break;
+			iters *= 2;
+		}
+		double best = 1e300;
+		for (int r = 0; r < reps; ++r)
+		{
+			const auto t0 = BenchClock::now();
+			for (uint64_t i = 0; i < iters; ++i) fn();
+			const double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - t0).count();
+			if (ns / static_cast<double>(iters) < best) best = ns / static_cast<double>(iters);
+		}
+		return best;
+	}
+
+	// Flat list of measurements. Each row is one number: suite and stage name what was measured,
+	// `param` is the varied size (joints, clip seconds, entity count), `unit` says how to read
+	// `value`. Rows keep their insertion order so diffs between runs line up.
+	class Report {
+	public:
+		struct Row {
+			std::string suite;
+			std::string stage;
+			std::string paramName;
+			double      param;
+			std::string unit;
+			double      value;
+		};
+
+		bool quick = false; // shorter timing windows, fewer sizes; for smoke runs
+
+		void add(const char* suite, const char* stage, const char* paramName, double param,
+		         const char* unit, double value)
+		{
+			rows.push_back({ suite, stage, paramName, param, unit, value });
+		}
+
+		// Timing window per measurement in ms.
+		double minMs() const { return quick ? 2.0 : 25.0; }
+
+		bool writeCsv(const char* path, const char* revision, unsigned threads) const
+		{
+			std::FILE* f = std::fopen(path, "w");
+			if (!f) return false;
+			std::fprintf(f, "revision,threads,suite,stage,param_name,param,unit,value\n");
+			for (const Row& r : rows)
+				std::fprintf(f, "%s,%u,%s,%s,%s,%g,%s,%.6g\n", revision, threads, r.suite.c_str(),
+				             r.stage.c_str(), r.paramName.c_str(), r.param, r.unit.c_str(), r.value);
+			std::fclose(f);
+			return true;
+		}
+
+		bool writeJson(const char* path, const char* revision, unsigned threads) const
+		{
+			std::FILE* f = std::fopen(path, "w");
+			if (!f) return false;
+			std::fprintf(f, "{\n  \"revision\": \"%s\",\n  \"threads\": %u,\n  \"quick\": %s,\n  \"results\": [\n",
+			             revision, threads, quick ? "true" : "false");
+			for (size_t i = 0; i < rows.size(); ++i)
+			{
+				const Row& r = rows[i];
+				std::fprintf(f, "    { \"suite\": \"%s\", \"stage\": \"%s\", \"%s\": %g, \"unit\": \"%s\", \"value\": %.6g }%s\n",
+				             r.suite.c_str(), r.stage.c_str(), r.paramName.c_str(), r.param, r.unit.c_str(), r.value,
+				             i + 1 < rows.size() ? "," : "");
+			}
+			std::fprintf(f, "  ]\n}\n");
+			std::fclose(f);
+			return true;
+		}
+
+	private:
+		std::vector<Row> rows;
+	};
+
+	// Suites (bench_animation.cpp, bench_stages.cpp, bench_transforms.cpp, bench_hierarchy.cpp,
+	// bench_instances.cpp, bench_models.cpp).
+	void benchLookup(Report& report);
+	void benchBake(Report& report);
+	void benchBlend(Report& report);
+	void benchStages(Report& report);
+	void benchTransforms(Report& report);
+	void benchHierarchy(Report& report);
+	void benchInstances(Report& report);
+	void benchModels(Report& report);
+
+} // namespace bench
@@ -0,0 +1,132 @@
+// Hierarchy propagation (HierachySystem::ApplyHiarchialChange) on 100k-node synthetic trees.
+//
+// Three shapes: `wide` (one root, every other node its child), `deep` (100 chains of 1000) and
+// `tree` (branching factor 4). Per pass, every child's world transform is recomputed with
+//   euler   the previous scheme: rebuild the parent's rotation from its Euler angles (6 trig),
+//           add Euler angles, then compose the child's matrix for the cache (6 more trig); serial
+//   matrix  world = parentWorld * local (local matrix cached), decomposed back to T/R/S for the
+//           component getters; serial, then each depth level split across WorkerPool
+// Reported as ms per pass.
+//
+// Both are models: the engine pass needs the registry, so these loops copy its arithmetic on
+// flat arrays (no skip rule, no attachments) and time that cost only. They check nothing about
+// HierachySystem itself and must be kept in step with it by hand.
+
+#include "bench_common.hpp"
+#include "bagel_worker_pool.hpp"
+#include "math/bagel_transform_batch.hpp"
+
+#include <algorithm>
+
+namespace bench {
+
+	struct HierNode {
+		int       parent = -1;
+		uint32_t  depth  = 0;
+		glm::vec3 lt{ 0.0f }, lr{ 0.0f }, ls{ 1.0f }; // local TRS under the parent
+		glm::vec3 t{ 0.0f }, r{ 0.0f }, s{ 1.0f };    // world TRS (component fields)
+		glm::mat4 local{ 1.0f }, world{ 1.0f };
+	};
+
+	struct Hierarchy {
+		std::vector<HierNode> nodes;       // stored parent-first
+		std::vector<uint32_t> levels;      // node indices bucketed by depth
+		std::vector<uint32_t> levelBegin;  // level d: levels[levelBegin[d], levelBegin[d + 1])
+	};
+
+	static Hierarchy makeHierarchy(int count, int (*parentOf)(int))
+	{
+		Hierarchy h;
+		h.nodes.resize(count);
+		for (int i = 0; i < count; ++i)
+		{
+			HierNode& n = h.nodes[i];
+			const float f = static_cast<float>(i);
+			n.parent = i == 0 ? -1 : parentOf(i);
+			n.depth  = n.parent < 0 ? 0 : h.nodes[n.parent].depth + 1;
+			n.lt = glm::vec3(std::sin(f), 1.0f, std::cos(f));
+			n.lr = glm::vec3(0.01f * std::sin(f * 0.3f), 0.02f, 0.01f * std::cos(f * 0.7f));
+			n.ls = glm::vec3(1.0f);
+			n.local = composeTransform(n.lt, n.lr, n.ls);
+		}
+		h.nodes[0].world = composeTransform(h.nodes[0].t, h.nodes[0].r, h.nodes[0].s);
+		uint32_t maxDepth = 0;
+		for (const HierNode& n : h.nodes) maxDepth = std::max(maxDepth, n.depth);
+		h.levelBegin.assign(maxDepth + 2, 0);
+		for (const HierNode& n : h.nodes) ++h.levelBegin[n.depth + 1];
+		for (size_t l = 1; l < h.levelBegin.size(); ++l) h.levelBegin[l] += h.levelBegin[l - 1];
+		h.levels.resize(count);
+		std::vector<uint32_t> cursor(h.levelBegin.begin(), h.levelBegin.end() - 1);
+		for (int i = 0; i < count; ++i) h.levels[cursor[h.nodes[i].depth]++] = static_cast<uint32_t>(i);
+		return h;
+	}
+
+	static void propagateEuler(Hierarchy& h)
+	{
+		for (HierNode& n : h.nodes)
+		{
+			if (n.parent < 0) continue;
+			const HierNode& p = h.nodes[n.parent];
+			const float c3 = std::cos(p.r.z), s3 = std::sin(p.r.z);
+			const float c2 = std::cos(p.r.y), s2 = std::sin(p.r.y);
+			const float c1 = std::cos(p.r.x), s1 = std::sin(p.r.x);
+			const glm::mat3 parentRot{
+				{ c2 * c3, c1 * s3 + c3 * s1 * s2, s1 * s3 - c1 * c3 * s2 },
+				{ -c2 * s3, c1 * c3 - s1 * s2 * s3, c3 * s1 + c1 * s2 * s3 },
+				{ s2, -c2 * s1, c1 * c2 } };
+			n.t = p.t + parentRot * (p.s * n.lt);
+			n.r = p.r + n.lr;
+			n.s = p.s * n.ls;
+			n.world = composeTransform(n.t, n.r, n.s); // what cacheTransforms then did
+		}
+	}
+
+	// Model of HierachySystem::ApplyHiarchialChange / propagate with every child recomputed.
+	static void propagateMatrix(Hierarchy& h)
+	{
+		for (size_t level = 1; level + 1 < h.levelBegin.size(); ++level)
+		{
+			const uint32_t begin = h.levelBegin[level];
+			const uint32_t count = h.levelBegin[level + 1] - begin;
+			WorkerPool::get().parallelFor(count, 512, [&](uint32_t b, uint32_t e, uint32_t) {
+				for (uint32_t i = begin + b; i < begin + e; ++i)
+				{
+					HierNode& n = h.nodes[h.levels[i]];
+					n.world = h.nodes[n.parent].world * n.local;
+					decomposeTransform(n.world, n.t, n.r, n.s);
+				}
+			});
+		}
+	}
+
+	static int wideParent(int)   { return 0; }
+	static int deepParent(int i) { return i <= 100 ? 0 : i - 100; } // 100 chains of ~1000
+	static int treeParent(int i) { return (i - 1) / 4; }
+
+	void benchHierarchy(Report& report)
+	{
+		struct Shape { const char* name; int (*parentOf)(int); };
+		const Shape shapes[] = { { "wide", wideParent }, { "deep", deepParent }, { "tree", treeParent } };
+		const int count = report.quick ? 20000 : 100000;
+		WorkerPool& pool = WorkerPool::get();
+
+		std::printf("\nhierarchy propagation, %d nodes, ms per pass, WorkerPool threads: %u\n", count, pool.threadCount());
+		std::printf("%6s %7s %12s %14s %12s %8s\n", "shape", "levels", "euler", "matrix serial", "matrix pool", "speedup");
+		for (const Shape& shape : shapes)
+		{
+			Hierarchy h = makeHierarchy(count, shape.parentOf);
+			const double euler = nsPerCall([&] { propagateEuler(h); }, report.minMs()) * 1e-6;
+			pool.setMaxThreads(1);
+			const double serial = nsPerCall([&] { propagateMatrix(h); }, report.minMs()) * 1e-6;
+			pool.setMaxThreads(0);
+			const double pooled = nsPerCall([&] { propagateMatrix(h); }, report.minMs()) * 1e-6;
+			std::printf("%6s %7zu %12.3f %14.3f %12.3f %7.2fx\n", shape.name, h.levelBegin.size() - 1,
+			            euler, serial, pooled, euler / pooled);
+			const std::string stage = std::string("propagate_") + shape.name;
+			report.add("hierarchy", (stage + "_euler").c_str(),         "nodes", count, "ms/pass", euler);
+			report.add("hierarchy", (stage + "_matrix_serial").c_str(), "nodes", count, "ms/pass", serial);
+			report.add("hierarchy", (stage + "_matrix_pool").c_str(),   "nodes", count, "ms/pass", pooled);
+		}
+	}
+
+} // namespace bench
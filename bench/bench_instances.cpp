@@ -0,0 +1,84 @@
+// Per-instance culling of an instanced batch (InstanceCullSystem::cull).
+//
+// 100k unit-cube instances scattered over a 1000 x 1000 field, seen by a camera at its centre
+// whose far plane sets how much of the field is in view. Per frame every instance is tested
+// against the camera alone (`camera`) or the camera and four shadow cascades (`5 views`), then each
+// view's survivors are compacted the way the engine fills its visible-instance buffer. Reported as
+// ns per instance for the whole step, beside the fraction of instances the g-buffer still draws
+// (before this, always all of them).
+
+#include "bench_common.hpp"
+#include "bagel_worker_pool.hpp"
+#include "math/bagel_instance_cull.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace bench {
+
+	static void makeField(size_t count, std::vector<glm::mat4>& out)
+	{
+		std::mt19937 rng(11);
+		std::uniform_real_distribution<float> pos(-500.0f, 500.0f), scl(0.5f, 2.0f);
+		out.resize(count);
+		for (glm::mat4& m : out)
+			m = glm::scale(glm::translate(glm::mat4(1.0f), { pos(rng), 0.0f, pos(rng) }), glm::vec3(scl(rng)));
+	}
+
+	// Cull + compact every view, the engine's chunk size; returns instances left for view 0.
+	static size_t cullPass(const std::vector<glm::mat4>& mats, const Frustum* views, uint32_t viewCount,
+	                       std::vector<uint8_t>& masks, std::vector<glm::mat4>& out)
+	{
+		const uint32_t count = static_cast<uint32_t>(mats.size());
+		const glm::vec3 bMin(-1.0f), bMax(1.0f);
+		WorkerPool::get().parallelFor(count, 4096, [&](uint32_t begin, uint32_t end, uint32_t) {
+			cullInstances(mats.data(), bMin, bMax, views, viewCount, masks.data(), begin, end);
+		});
+		size_t cursor = 0, inCamera = 0;
+		for (uint32_t v = 0; v < viewCount; ++v)
+		{
+			const size_t n = compactInstances(mats.data(), masks.data(), count, static_cast<uint8_t>(1u << v),
+			                                  out.data() + cursor, out.size() - cursor);
+			if (v == 0) inCamera = n;
+			cursor += n;
+		}
+		return inCamera;
+	}
+
+	void benchInstances(Report& report)
+	{
+		const size_t count = 100000;
+		std::vector<glm::mat4> mats;
+		makeField(count, mats);
+		std::vector<uint8_t> masks(count);
+		std::vector<glm::mat4> out(count * (1 + 4));
+
+		const glm::vec3 eye(0.0f, 10.0f, 0.0f);
+		const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -0.2f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		std::printf("\ninstanced batch culling, %zu instances, ns per instance\n", count);
+		std::printf("%8s %10s %12s %12s\n", "far", "visible", "camera", "5 views");
+		for (float farPlane : { 50.0f, 200.0f, 1000.0f })
+		{
+			Frustum views[5];
+			views[0].extractFromVP(glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, farPlane) * view);
+			// Cascades: growing light-space boxes around the camera, looking straight down.
+			const glm::mat4 lightView = glm::lookAt(eye + glm::vec3(0.0f, 200.0f, 0.0f), eye, glm::vec3(0.0f, 0.0f, 1.0f));
+			const float extents[4] = { 10.0f, 30.0f, 100.0f, 300.0f };
+			for (int c = 0; c < 4; ++c)
+				views[1 + c].extractFromVP(glm::ortho(-extents[c], extents[c], -extents[c], extents[c], 0.0f, 400.0f) * lightView);
+
+			size_t visible = 0;
+			const double n = static_cast<double>(count);
+			const double camera = nsPerCall([&] { visible = cullPass(mats, views, 1, masks, out); }, report.minMs()) / n;
+			const double all    = nsPerCall([&] { cullPass(mats, views, 5, masks, out); }, report.minMs()) / n;
+			const double fraction = static_cast<double>(visible) / n;
+
+			std::printf("%8.0f %9.1f%% %12.2f %12.2f\n", farPlane, fraction * 100.0, camera, all);
+			report.add("instances", "visible_fraction", "far", farPlane, "fraction", fraction);
+			report.add("instances", "cull_camera",      "far", farPlane, "ns/instance", camera);
+			report.add("instances", "cull_5_views",     "far", farPlane, "ns/instance", all);
+		}
+	}
+
+} // namespace bench
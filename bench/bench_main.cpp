@@ -0,0 +1,73 @@
+// BagelBench entry point.
+//
+//   BagelBench [--suite all|lookup|bake|blend|stages|transforms|hierarchy|instances|models] [--csv out.csv] [--json out.json] [--quick]
+//
+// Tables go to stdout; --csv / --json additionally write every measurement as one row tagged with
+// the git revision the binary was built from, so runs can be collected and compared across
+// versions. --quick shortens the timing windows and drops the largest sizes (smoke runs / CI).
+
+#include "bench_common.hpp"
+#include "bagel_worker_pool.hpp"
+
+#include <cstring>
+
+#ifndef BAGEL_BENCH_REVISION
+#define BAGEL_BENCH_REVISION "unknown"
+#endif
+
+using namespace bench;
+
+static void usage()
+{
+	std::printf("usage: BagelBench [--suite all|lookup|bake|blend|stages|transforms|hierarchy|instances|models] [--csv FILE] [--json FILE] [--quick]\n");
+}
+
+int main(int argc, char** argv)
+{
+	const char* suite = "all";
+	const char* csvPath = nullptr;
+	const char* jsonPath = nullptr;
+	Report report;
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (!std::strcmp(argv[i], "--suite") && hasValue)     suite = argv[++i];
+		else if (!std::strcmp(argv[i], "--csv") && hasValue)  csvPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--json") && hasValue) jsonPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--quick"))            report.quick = true;
+		else { usage(); return 2; }
+	}
+
+	struct Suite { const char* name; void (*run)(Report&); };
+	const Suite suites[] = {
+		{ "lookup", benchLookup },
+		{ "bake",   benchBake },
+		{ "blend",  benchBlend },
+		{ "stages", benchStages },
+		{ "transforms", benchTransforms },
+		{ "hierarchy",  benchHierarchy },
+		{ "instances",  benchInstances },
+		{ "models",     benchModels },
+	};
+	bool ran = false;
+	for (const Suite& s : suites)
+	{
+		if (std::strcmp(suite, "all") != 0 && std::strcmp(suite, s.name) != 0) continue;
+		s.run(report);
+		ran = true;
+	}
+	if (!ran) { usage(); return 2; }
+
+	const unsigned threads = WorkerPool::get().threadCount();
+	if (csvPath && !report.writeCsv(csvPath, BAGEL_BENCH_REVISION, threads))
+	{
+		std::fprintf(stderr, "BagelBench: cannot write %s\n", csvPath);
+		return 1;
+	}
+	if (jsonPath && !report.writeJson(jsonPath, BAGEL_BENCH_REVISION, threads))
+	{
+		std::fprintf(stderr, "BagelBench: cannot write %s\n", jsonPath);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,133 @@
+// Per-entity model state as the render passes stream it (GBufferRenderSystem::renderEntities and
+// ShadowRenderSystem::renderShadowCasters, single-transform loop).
+//
+// Both loops walk every model entity each frame: read the ModelComponent, skip skinned models,
+// frustum-test the shared mesh's bounds under the entity's matrix and build the push constant
+// from the skin row. `fat` is the component as it was with the build recipe inline (a
+// ModelLoadSettings and MAX_MATERIALS MaterialSources, all std::strings), `slim` is the hot
+// ModelComponent left after the recipe moved to ModelRecipeComponent. The layouts below mirror
+// the engine structs field for field (the real ones need Vulkan headers). Reported as bytes per
+// entity and ns per entity for one g-buffer pass and for four shadow cascades.
+
+#include "bench_common.hpp"
+#include "math/bagel_math.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace bench {
+
+	// Shared, cache-owned geometry: the few fields of Model the loops read.
+	struct MeshStandIn {
+		glm::vec3 aabbMin{ -1.0f }, aabbMax{ 1.0f };
+		uint16_t skinBase = 0, numSlots = 1;
+		bool isSkinned = false;
+	};
+
+	struct LoadSettingsLayout { // ModelLoadSettings
+		std::string source;
+		float scale = 1.0f;
+		glm::vec3 scaleVec{ 1.0f };
+		int buildMode = 0;
+		uint32_t maxPrimitives = UINT32_MAX;
+		bool isDeformable = false, isDynamic = false, mergeSolidSubmeshes = true;
+	};
+	struct MaterialSourceLayout { std::string albedo, normal, metalRough, emission; };
+
+	struct FatModel { // ModelComponent before the split
+		const MeshStandIn* model = nullptr;
+		LoadSettingsLayout loadSettings;
+		MaterialSourceLayout materialSources[8];
+		uint32_t materialCount = 0;
+		uint8_t skinIndex = 0;
+		bool frustumCull = true;
+	};
+	struct SlimModel { // ModelComponent after it
+		const MeshStandIn* model = nullptr;
+		uint8_t skinIndex = 0;
+		bool frustumCull = true;
+	};
+
+	// One pass of the loop body both render systems share; returns the number of draws.
+	template <class M>
+	static uint32_t drawPass(const std::vector<glm::mat4>& mats, const std::vector<M>& models,
+	                         const Frustum& frustum, uint32_t& rowSum)
+	{
+		uint32_t draws = 0;
+		for (size_t i = 0; i < models.size(); ++i)
+		{
+			const M& m = models[i];
+			if (m.model->isSkinned) continue;
+			if (m.frustumCull && !frustum.testAABB(m.model->aabbMin, m.model->aabbMax, mats[i]))
+				continue;
+			rowSum += m.model->skinBase + m.skinIndex * m.model->numSlots;
+			++draws;
+		}
+		return draws;
+	}
+
+	template <class M>
+	static void fillModels(std::vector<M>& models, const std::vector<MeshStandIn>& meshes)
+	{
+		for (size_t i = 0; i < models.size(); ++i)
+		{
+			models[i].model = &meshes[i % meshes.size()];
+			models[i].skinIndex = static_cast<uint8_t>(i & 3);
+		}
+	}
+
+	void benchModels(Report& report)
+	{
+		std::vector<MeshStandIn> meshes(16);
+		meshes[15].isSkinned = true;
+
+		std::printf("\nmodel component streaming: %zu vs %zu bytes per entity, ns per entity\n",
+		            sizeof(FatModel), sizeof(SlimModel));
+		std::printf("%8s %12s %12s %8s %12s %12s %8s\n", "entities", "gbuf fat", "gbuf slim", "speedup",
+		            "shadow fat", "shadow slim", "speedup");
+		report.add("models", "bytes_fat",  "entities", 1, "bytes", static_cast<double>(sizeof(FatModel)));
+		report.add("models", "bytes_slim", "entities", 1, "bytes", static_cast<double>(sizeof(SlimModel)));
+
+		const glm::vec3 eye(0.0f, 10.0f, 0.0f);
+		const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -0.2f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		Frustum camera;
+		camera.extractFromVP(glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 300.0f) * view);
+		const glm::mat4 lightView = glm::lookAt(eye + glm::vec3(0.0f, 200.0f, 0.0f), eye, glm::vec3(0.0f, 0.0f, 1.0f));
+		Frustum cascades[4];
+		const float extents[4] = { 10.0f, 30.0f, 100.0f, 300.0f };
+		for (int c = 0; c < 4; ++c)
+			cascades[c].extractFromVP(glm::ortho(-extents[c], extents[c], -extents[c], extents[c], 0.0f, 400.0f) * lightView);
+
+		std::vector<size_t> sizes = { 1000, 10000, 100000 };
+		if (report.quick) sizes.pop_back();
+		for (size_t count : sizes)
+		{
+			std::mt19937 rng(5);
+			std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+			std::vector<glm::mat4> mats(count);
+			for (glm::mat4& m : mats)
+				m = glm::translate(glm::mat4(1.0f), { pos(rng), 0.0f, pos(rng) });
+			std::vector<FatModel> fat(count);
+			std::vector<SlimModel> slim(count);
+			fillModels(fat, meshes);
+			fillModels(slim, meshes);
+
+			uint32_t draws = 0, rows = 0;
+			const double n = static_cast<double>(count);
+			const double gFat  = nsPerCall([&] { draws += drawPass(mats, fat, camera, rows); }, report.minMs()) / n;
+			const double gSlim = nsPerCall([&] { draws += drawPass(mats, slim, camera, rows); }, report.minMs()) / n;
+			const double sFat  = nsPerCall([&] { for (const Frustum& f : cascades) draws += drawPass(mats, fat, f, rows); }, report.minMs()) / n;
+			const double sSlim = nsPerCall([&] { for (const Frustum& f : cascades) draws += drawPass(mats, slim, f, rows); }, report.minMs()) / n;
+			if (draws + rows == 1) std::printf(" "); // keep the passes observable
+
+			std::printf("%8zu %12.2f %12.2f %7.2fx %12.2f %12.2f %7.2fx\n", count, gFat, gSlim, gFat / gSlim,
+			            sFat, sSlim, sFat / sSlim);
+			const double param = static_cast<double>(count);
+			report.add("models", "gbuffer_fat",  "entities", param, "ns/entity", gFat);
+			report.add("models", "gbuffer_slim", "entities", param, "ns/entity", gSlim);
+			report.add("models", "shadow_fat",   "entities", param, "ns/entity", sFat);
+			report.add("models", "shadow_slim",  "entities", param, "ns/entity", sSlim);
+		}
+	}
+
+} // namespace bench
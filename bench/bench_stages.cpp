@@ -0,0 +1,100 @@
+// Per-stage throughput of the CPU animation pipeline across rig sizes.
+//
+// Each stage the engine runs per skinned entity is timed on its own, on a character-shaped
+// synthetic rig (makeLimbRig: limbs of four joints off a root) of 16 to 512 joints:
+//   sample   sampleClip through an AnimEvalContext, playing forward at 60 fps
+//   resolve  resolveGlobals of that pose
+//   palette  globalsToPalette of those globals
+//   manual   applyManualPose with four IK setups into a ManualPoseScratch (the manual-pose path)
+//   ik       one solveTwoBoneIK on a limb
+//   bake     bakeClips of 4 clips x 2 s at cfg::kAnimBakeFps on the full WorkerPool (load time)
+// Figures are ns per call (bake: ms per rig); the ns/joint columns should stay flat with size.
+
+#include "bench_common.hpp"
+#include "bagel_worker_pool.hpp"
+#include "engine/bagel_engine_config.hpp"
+
+namespace bench {
+
+	// Four IK setups on the first limbs, each reaching for the tip of the next limb.
+	static std::vector<IKSetup> makeIKSetups(int joints)
+	{
+		std::vector<IKSetup> iks;
+		const int limbs = (joints - 1) / LIMB_LENGTH;
+		for (int l = 0; l + 1 < limbs && iks.size() < 4; ++l)
+		{
+			const int base = 1 + l * LIMB_LENGTH;
+			const int next = base + LIMB_LENGTH;
+			IKSetup s;
+			s.thigh     = base;
+			s.shin      = base + 1;
+			s.foot      = base + 2;
+			s.goalJoint = next + 2;
+			s.poleJoint = next + 1;
+			iks.push_back(s);
+		}
+		return iks;
+	}
+
+	void benchStages(Report& report)
+	{
+		const double minMs = report.minMs();
+		std::printf("\nanimation pipeline stages, limb rig, ns per call (bake: ms), WorkerPool threads: %u\n",
+		            WorkerPool::get().threadCount());
+		std::printf("%7s %10s %10s %10s %10s %10s %10s %12s\n",
+		            "joints", "sample", "resolve", "palette", "manual", "ik", "bake ms", "pipe ns/jnt");
+		for (int joints : { 16, 32, 64, 128, 256, 512 })
+		{
+			if (report.quick && joints > 64) break;
+			const SkeletonData skel = makeLimbRig(joints);
+			const AnimationClip clip = makeClip(joints, 2.5f, 30.0f);
+
+			AnimEvalContext ctx;
+			Pose pose;
+			float t = 0.0f;
+			const double sample = nsPerCall([&] {
+				sampleClip(skel, clip, t, pose, ctx);
+				t += 1.0f / PLAY_RATE;
+				if (t > clip.duration) t -= clip.duration;
+			}, minMs);
+
+			std::vector<glm::mat4> globals;
+			const double resolve = nsPerCall([&] { resolveGlobals(skel, pose, globals); }, minMs);
+
+			std::vector<PaletteMatrix> palette(joints);
+			const double toPalette = nsPerCall([&] { globalsToPalette(skel, globals, palette.data()); }, minMs);
+
+			const std::vector<IKSetup> iks = makeIKSetups(joints);
+			ManualPoseScratch manualScratch;
+			const double manual = nsPerCall([&] { applyManualPose(skel, pose, iks, manualScratch); }, minMs);
+
+			TwoBoneIK ik;
+			ik.thigh = 1; ik.shin = 2; ik.foot = 3;
+			ik.goalModelSpace = glm::vec3(1.0f, -1.5f, 0.5f);
+			ik.poleModelSpace = glm::vec3(1.0f, -1.0f, 2.0f);
+			Pose ikPose = pose;
+			const double solve = nsPerCall([&] { ikPose = pose; solveTwoBoneIK(skel, ik, ikPose); }, minMs);
+
+			std::vector<AnimationClip> clips;
+			for (int c = 0; c < 4; ++c) clips.push_back(makeClip(joints, 2.0f, 30.0f));
+			const double bakeMs = nsPerCall([&] {
+				BakedAnimation baked = bakeClips(skel, clips, cfg::kAnimBakeFps);
+				if (baked.matrices.empty()) std::printf(" ");
+			}, minMs, 1) * 1e-6;
+
+			// The per-frame live path: sample -> resolve -> palette.
+			const double pipePerJoint = (sample + resolve + toPalette) / joints;
+			std::printf("%7d %10.0f %10.0f %10.0f %10.0f %10.0f %10.3f %12.2f\n",
+			            joints, sample, resolve, toPalette, manual, solve, bakeMs, pipePerJoint);
+
+			report.add("stages", "sample",  "joints", joints, "ns/call", sample);
+			report.add("stages", "resolve", "joints", joints, "ns/call", resolve);
+			report.add("stages", "palette", "joints", joints, "ns/call", toPalette);
+			report.add("stages", "manual",  "joints", joints, "ns/call", manual);
+			report.add("stages", "ik",      "joints", joints, "ns/call", solve);
+			report.add("stages", "bake",    "joints", joints, "ms/call", bakeMs);
+			report.add("stages", "live_pipeline", "joints", joints, "ns/joint", pipePerJoint);
+		}
+	}
+
+} // namespace bench
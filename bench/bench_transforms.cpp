@@ -0,0 +1,128 @@
+// Transform finalization throughput (Application::cacheTransforms).
+//
+// 100k and 1M random transforms are packed into a TransformSoA once, then composed to model
+// matrices by the scalar reference (std::sin/std::cos per transform, what computeMat4 does) and by
+// the four-wide composeTransforms kernel. Reported as ns per transform; `max err` is the largest
+// element difference between the two, relative to the element's magnitude.
+//
+// Then the scaling curve of the chunked pass Application::cacheTransforms runs on WorkerPool
+// (pack world TRS into the SoA -> composeTransforms -> store), over 1M transforms with the pool
+// capped to 1, 2, 4, ... threads. Every run is checked byte for byte against the 1-thread result.
+
+#include "bench_common.hpp"
+#include "math/bagel_transform_batch.hpp"
+#include "bagel_worker_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace bench {
+
+	// Stand-in for TransformComponent: world values in AoS, the matrix cached beside them.
+	struct BenchTransform {
+		glm::vec3 translation, rotation, scale;
+		glm::mat4 cached;
+	};
+
+	static void makeTransforms(size_t count, std::vector<BenchTransform>& out)
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> pos(-500.0f, 500.0f), ang(-6.3f, 6.3f), scl(0.05f, 4.0f);
+		out.resize(count);
+		for (BenchTransform& t : out)
+		{
+			t.translation = { pos(rng), pos(rng), pos(rng) };
+			t.rotation    = { ang(rng), ang(rng), ang(rng) };
+			t.scale       = { scl(rng), scl(rng), scl(rng) };
+		}
+	}
+
+	// The cacheTransforms chunk body, same grain as the engine.
+	static void cachePass(std::vector<BenchTransform>& ts, TransformSoA& soa, std::vector<glm::mat4>& mats)
+	{
+		const uint32_t count = static_cast<uint32_t>(ts.size());
+		WorkerPool::get().parallelFor(count, 2048, [&](uint32_t begin, uint32_t end, uint32_t) {
+			for (uint32_t i = begin; i < end; ++i)
+				soa.set(i, ts[i].translation, ts[i].rotation, ts[i].scale);
+			composeTransforms(soa, mats.data(), begin, end);
+			for (uint32_t i = begin; i < end; ++i)
+				ts[i].cached = mats[i];
+		});
+	}
+
+	static void benchTransformScaling(Report& report)
+	{
+		const size_t count = report.quick ? 100000 : 1000000;
+		std::vector<BenchTransform> ts;
+		makeTransforms(count, ts);
+		TransformSoA soa;
+		soa.resize(count);
+		std::vector<glm::mat4> mats(count);
+
+		WorkerPool& pool = WorkerPool::get();
+		std::printf("\ncacheTransforms pass (pack + compose + store), %zu transforms, WorkerPool threads: %u\n",
+		            count, pool.threadCount());
+		std::printf("%8s %12s %10s %10s\n", "threads", "ms/pass", "speedup", "identical");
+		std::vector<glm::mat4> serial;
+		double serialMs = 0.0;
+		for (uint32_t threads = 1;; threads *= 2)
+		{
+			const uint32_t used = std::min(threads, pool.threadCount());
+			pool.setMaxThreads(used);
+			const double ms = nsPerCall([&] { cachePass(ts, soa, mats); }, report.minMs()) * 1e-6;
+			pool.setMaxThreads(0);
+
+			bool same = true;
+			if (used == 1)
+			{
+				serialMs = ms;
+				serial.resize(count);
+				for (size_t i = 0; i < count; ++i) serial[i] = ts[i].cached;
+			}
+			else
+				for (size_t i = 0; i < count && same; ++i)
+					same = std::memcmp(&serial[i], &ts[i].cached, sizeof(glm::mat4)) == 0;
+
+			std::printf("%8u %12.3f %9.2fx %10s\n", used, ms, serialMs / ms, same ? "yes" : "NO");
+			report.add("transforms", "cache_pass", "threads", used, "ms/pass", ms);
+			if (used == pool.threadCount()) break;
+		}
+	}
+
+	void benchTransforms(Report& report)
+	{
+		std::printf("\ntransform finalization (compose world TRS -> mat4), ns per transform\n");
+		std::printf("%10s %12s %12s %8s %12s\n", "count", "scalar", "batch", "speedup", "max err");
+		for (size_t count : { size_t(100000), size_t(1000000) })
+		{
+			if (report.quick && count > 100000) break;
+			std::vector<BenchTransform> ts;
+			makeTransforms(count, ts);
+			TransformSoA soa;
+			soa.resize(count);
+			for (size_t i = 0; i < count; ++i)
+				soa.set(i, ts[i].translation, ts[i].rotation, ts[i].scale);
+
+			std::vector<glm::mat4> ref(count), out(count);
+			const double n = static_cast<double>(count);
+			const double scalar = nsPerCall([&] { composeTransformsScalar(soa, ref.data(), 0, count); }, report.minMs()) / n;
+			const double batch  = nsPerCall([&] { composeTransforms(soa, out.data(), 0, count); }, report.minMs()) / n;
+
+			double maxErr = 0.0;
+			for (size_t i = 0; i < count; ++i)
+				for (int c = 0; c < 4; ++c)
+					for (int r = 0; r < 4; ++r)
+					{
+						const double a = ref[i][c][r], b = out[i][c][r];
+						maxErr = std::max(maxErr, std::fabs(a - b) / std::max(1.0, std::fabs(a)));
+					}
+
+			std::printf("%10zu %12.2f %12.2f %7.2fx %12.2e\n", count, scalar, batch, scalar / batch, maxErr);
+			report.add("transforms", "compose_scalar", "transforms", n, "ns/transform", scalar);
+			report.add("transforms", "compose_batch",  "transforms", n, "ns/transform", batch);
+		}
+		benchTransformScaling(report);
+	}
+
+} // namespace bench
@@ -67,6 +67,9 @@ if errorlevel 1 (echo [FAIL] bloom_upsample.frag     & set /a ERRORS+=1) else ec
 "%GLSLC%" "%S%\smaa_edge.frag"     -o "%S%\smaa_edge.frag.spv"
 if errorlevel 1 (echo [FAIL] smaa_edge.frag     & set /a ERRORS+=1) else echo [OK] smaa_edge.frag
 
+"%GLSLC%" "%S%\skin_vertices.comp"     -o "%S%\skin_vertices.comp.spv"
+if errorlevel 1 (echo [FAIL] skin_vertices.comp     & set /a ERRORS+=1) else echo [OK] skin_vertices.comp
+
 
 if %ERRORS% gtr 0 (
     echo %ERRORS% shader^(s^) failed. Aborting.
@@ -35,7 +35,7 @@ echo
 echo "=== Compiling shaders ==="
 shopt -s nullglob
 shader_errors=0
-for src in shaders/*.vert shaders/*.frag; do
+for src in shaders/*.vert shaders/*.frag shaders/*.comp; do
   if "$GLSLC" "$src" -o "$src.spv"; then
     echo "[OK]   $(basename "$src")"
   else
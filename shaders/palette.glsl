@@ -0,0 +1,62 @@
+// Skinning palette + influence SSBOs shared by the skinned vertex shaders.
+#ifndef PALETTE_GLSL
+#define PALETTE_GLSL
+
+// Per-vertex skin influences: joints packed into one uint (4×u8), weights as unorm4x8.
+struct SkinInf { uint joints; uint weights; };
+layout(set = 0, binding = 9)  readonly buffer SkinBuf { SkinInf v[]; } skinBuf;
+
+// Baked joint palette, 3x4 affine rows per joint (PaletteMatrix on the CPU, 48 bytes): the
+// bottom (0,0,0,1) row of a rigid joint matrix is never stored. Indexed m[animBaseOffset + joint].
+struct PaletteRow { vec4 r0; vec4 r1; vec4 r2; };
+layout(set = 0, binding = 10) readonly buffer PaletteBuf { PaletteRow m[]; } palette;
+
+// Per-instance records of an instanced skinned draw (SkinInstance on the CPU, 80 bytes), one
+// buffer per frame in flight. Indexed by gl_InstanceIndex, which already includes firstInstance.
+struct SkinInstance {
+	mat4  modelMatrix;
+	uint  animBaseOffset;
+	uint  animNextOffset;
+	float animFrameBlend;
+	uint  materialRowBase;
+};
+layout(set = 0, binding = 11) readonly buffer SkinInstanceBuf { SkinInstance v[]; } skinInstances;
+
+// Weighted sum of the four influencing joints' rows at palette base `base`.
+PaletteRow blendRows(uint base, uvec4 j, vec4 w) {
+	PaletteRow a = palette.m[base + j.x];
+	PaletteRow b = palette.m[base + j.y];
+	PaletteRow c = palette.m[base + j.z];
+	PaletteRow d = palette.m[base + j.w];
+	PaletteRow r;
+	r.r0 = w.x * a.r0 + w.y * b.r0 + w.z * c.r0 + w.w * d.r0;
+	r.r1 = w.x * a.r1 + w.y * b.r1 + w.z * c.r1 + w.w * d.r1;
+	r.r2 = w.x * a.r2 + w.y * b.r2 + w.z * c.r2 + w.w * d.r2;
+	return r;
+}
+
+// Linear blend skinning for vertex `vertexIndex` of a model whose influences start at
+// skinVertexBase: sum of weightᵢ · palette[animBase + jointᵢ]. With frameBlend > 0 the same sum
+// at nextBase (the following baked frame) is mixed in, so clips baked at a low rate still play
+// smoothly. The rows are blended (still affine) and expanded to a mat4 once, so callers compose
+// it like any model matrix.
+mat4 skinMatrix(uint skinVertexBase, uint animBase, uint nextBase, float frameBlend, uint vertexIndex) {
+	SkinInf s = skinBuf.v[skinVertexBase + vertexIndex];
+	uvec4 j = uvec4(s.joints & 0xFFu, (s.joints >> 8) & 0xFFu, (s.joints >> 16) & 0xFFu, (s.joints >> 24) & 0xFFu);
+	vec4  w = unpackUnorm4x8(s.weights);
+	PaletteRow r = blendRows(animBase, j, w);
+	// frameBlend is per instance: the branch is uniform across each instance's vertices.
+	if (frameBlend > 0.0) {
+		PaletteRow n = blendRows(nextBase, j, w);
+		r.r0 = mix(r.r0, n.r0, frameBlend);
+		r.r1 = mix(r.r1, n.r1, frameBlend);
+		r.r2 = mix(r.r2, n.r2, frameBlend);
+	}
+	// Rows -> GLSL column-major mat4 (bottom row (0,0,0,1)).
+	return mat4(r.r0.x, r.r1.x, r.r2.x, 0.0,
+	            r.r0.y, r.r1.y, r.r2.y, 0.0,
+	            r.r0.z, r.r1.z, r.r2.z, 0.0,
+	            r.r0.w, r.r1.w, r.r2.w, 1.0);
+}
+
+#endif
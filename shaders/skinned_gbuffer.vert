@@ -5,10 +5,13 @@
 
 #extension GL_GOOGLE_include_directive : require
 #include "pbr.glsl"
+#include "palette.glsl"
 // Skeletal-skinning G-buffer vertex shader. Same outputs as gbuffer_fill.vert (so it reuses
 // gbuffer_fill.frag), but it skins the position/normal/tangent with a per-vertex joint blend.
 // Per-vertex joints/weights are NOT vertex attributes — they live in an SSBO indexed by
 // (skinVertexBase + gl_VertexIndex), keeping the static vertex format untouched.
+// Instanced: every entity sharing the Model is one instance; its model matrix, palette rows and
+// material come from skinInstances.v[gl_InstanceIndex] (palette.glsl).
 
 layout(location=0) in vec3 position;
 layout(location=1) in vec3 color;
@@ -39,39 +42,26 @@ layout(set = 0, binding = 8) readonly buffer SkinTable {
 	uvec4 entries[];
 } skinTable;
 
-// Per-vertex skin influences: joints packed into one uint (4×u8), weights as unorm4x8.
-struct SkinInf { uint joints; uint weights; };
-layout(set = 0, binding = 9)  readonly buffer SkinBuf    { SkinInf v[]; } skinBuf;
-// Baked joint-matrix palette: m[animBaseOffset + jointIndex].
-layout(set = 0, binding = 10) readonly buffer PaletteBuf { mat4 m[];   } palette;
+// Skin influences (binding 9), 3x4 joint palette (binding 10) and the per-instance records
+// (binding 11) come from palette.glsl.
 
 layout(set = 0, binding = 6) uniform sampler2D samplerColor[];
 
-// Layout matches GBufferPushConstantData: offsets 80/84 (the buffered-transform slots in the
-// static path) are repurposed here for skinVertexBase/animBaseOffset. The frag (gbuffer_fill)
-// only reads materialRowBase/emissionLux/fallbackAlbedoMap at 88/92/96 — unchanged.
+// Shares the push range with gbuffer_fill.frag, which reads emissionLux/fallbackAlbedoMap at
+// 92/96. Everything per entity is per instance now, so only the model-wide skin base is pushed,
+// in the slot the static pass uses for its buffered-transform handle.
 layout(push_constant) uniform Push {
-	mat4 modelMatrix;
-	vec4 scale;
-	uint skinVertexBase;
-	uint animBaseOffset;
-	uint materialRowBase;
-	float emissionLux;
-	uint fallbackAlbedoMap;
+	layout(offset = 80) uint skinVertexBase;
 } push;
 
 void main() {
+	SkinInstance inst = skinInstances.v[gl_InstanceIndex];
+
 	// Linear blend skinning: sum of weightᵢ · palette[joint ᵢ].
-	SkinInf s = skinBuf.v[push.skinVertexBase + gl_VertexIndex];
-	uvec4 j = uvec4(s.joints & 0xFFu, (s.joints >> 8) & 0xFFu, (s.joints >> 16) & 0xFFu, (s.joints >> 24) & 0xFFu);
-	vec4  w = unpackUnorm4x8(s.weights);
-	uint pb = push.animBaseOffset;
-	mat4 skin = w.x * palette.m[pb + j.x]
-	          + w.y * palette.m[pb + j.y]
-	          + w.z * palette.m[pb + j.z]
-	          + w.w * palette.m[pb + j.w];
-
-	mat4 modelMatrix  = push.modelMatrix * skin;
+	mat4 skin = skinMatrix(push.skinVertexBase, inst.animBaseOffset, inst.animNextOffset,
+	                       inst.animFrameBlend, uint(gl_VertexIndex));
+
+	mat4 modelMatrix  = inst.modelMatrix * skin;
 	mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
 	vec4 positionWorld = modelMatrix * vec4(position, 1.0);
 	gl_Position = ubo.projectionMatrix * ubo.viewMatrix * positionWorld;
@@ -81,7 +71,7 @@ void main() {
 	fragNormalWorld = normalize(normalMatrix * normal);
 	vs_out.isInstancedTransform = 0;
 
-	uvec4 mat = skinTable.entries[push.materialRowBase + in_materialIndex];
+	uvec4 mat = skinTable.entries[inst.materialRowBase + in_materialIndex];
 	vs_out.albedoMap     = mat.x;
 	vs_out.normalMap     = mat.y;
 	vs_out.metalRoughMap = mat.z;
@@ -1,9 +1,11 @@
 #include "animation/bagel_animation.hpp"
+#include "bagel_worker_pool.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 namespace bagel {
@@ -16,23 +18,49 @@ namespace bagel {
 		return m;
 	}
 
+	// How many keys a cursor may walk forward before the lookup gives up and binary-searches.
+	// Per-frame playback advances by at most a key or two; anything further is a seek.
+	static constexpr int MAX_CURSOR_WALK = 4;
+
 	// Locate the keyframe interval [i0, i1] bracketing `t` and the fractional position between
 	// them. Clamps to the endpoints (no extrapolation), matching glTF sampling at clip ends.
-	static void findKeyframe(const std::vector<float>& times, float t, int& i0, int& i1, float& frac)
+	// With a `cursor`, the search starts from the key found last time when `t` has not moved
+	// backwards past it, and the cursor is updated to the new i0. Either way i0 is the last key
+	// with times[i0] <= t, so the cursor never changes the result — only the cost of finding it.
+	static void findKeyframe(const std::vector<float>& times, float t, uint32_t* cursor,
+	                         int& i0, int& i1, float& frac)
 	{
 		i0 = i1 = 0; frac = 0.0f;
 		const int n = static_cast<int>(times.size());
 		if (n == 0) return;
-		if (t <= times.front()) { i0 = i1 = 0;       return; }
-		if (t >= times.back())  { i0 = i1 = n - 1;    return; }
-		int i = 0;
-		while (i + 1 < n && times[i + 1] <= t) ++i;
+		if (t <= times.front()) { i0 = i1 = 0;       if (cursor) *cursor = 0;                          return; }
+		if (t >= times.back())  { i0 = i1 = n - 1;    if (cursor) *cursor = static_cast<uint32_t>(n - 1); return; }
+
+		// times.front() < t < times.back() from here, so the bracketing key is in [0, n-2] and
+		// times[i + 1] is always in range while walking.
+		int i = -1;
+		if (cursor && static_cast<int>(*cursor) < n && times[*cursor] <= t)
+		{
+			int walk = static_cast<int>(*cursor);
+			for (int step = 0; step < MAX_CURSOR_WALK; ++step)
+			{
+				if (times[walk + 1] > t) { i = walk; break; }
+				++walk;
+			}
+		}
+		if (i < 0)
+			i = static_cast<int>(std::upper_bound(times.begin(), times.end(), t) - times.begin()) - 1;
+		if (cursor) *cursor = static_cast<uint32_t>(i);
+
 		i0 = i; i1 = i + 1;
 		const float d = times[i1] - times[i0];
 		frac = d > 0.0f ? (t - times[i0]) / d : 0.0f;
 	}
 
-	void sampleClip(const SkeletonData& skel, const AnimationClip& clip, float time, Pose& outPose)
+	// Shared body of both sampleClip overloads. `cursors` is null (binary search every channel)
+	// or holds one entry per clip sampler.
+	static void sampleClipImpl(const SkeletonData& skel, const AnimationClip& clip, float time,
+	                           Pose& outPose, uint32_t* cursors)
 	{
 		outPose = skel.restPose; // start from the rest pose; unanimated joints stay at rest
 		const int jointCount = static_cast<int>(skel.jointCount());
@@ -42,24 +70,24 @@ namespace bagel {
 			if (ch.joint < 0 || ch.joint >= jointCount) continue;
 			if (ch.sampler < 0 || ch.sampler >= static_cast<int>(clip.samplers.size())) continue;
 			const AnimSampler& s = clip.samplers[ch.sampler];
-			if (s.times.empty() || s.values.empty()) continue;
+			if (s.times.empty() || s.valueCount() == 0) continue;
 
 			int i0, i1; float f;
-			findKeyframe(s.times, time, i0, i1, f);
+			findKeyframe(s.times, time, cursors ? &cursors[ch.sampler] : nullptr, i0, i1, f);
 
 			// CUBICSPLINE packs (inTangent, value, outTangent) per key; we read the value slot
 			// and interpolate linearly (tangents ignored — a documented approximation).
 			const int stride = (s.interp == Interp::CUBICSPLINE) ? 3 : 1;
 			const int vmid   = (s.interp == Interp::CUBICSPLINE) ? 1 : 0;
-			const glm::vec4 a = s.values[static_cast<size_t>(i0) * stride + vmid];
-			const glm::vec4 b = s.values[static_cast<size_t>(i1) * stride + vmid];
+			const glm::vec4 a = s.value(static_cast<size_t>(i0) * stride + vmid);
+			const glm::vec4 b = s.value(static_cast<size_t>(i1) * stride + vmid);
 
 			JointTransform& jt = outPose[ch.joint];
 			if (ch.path == AnimPath::ROTATION)
 			{
 				const glm::quat qa(a.w, a.x, a.y, a.z); // glTF stores xyzw; glm::quat takes (w,x,y,z)
 				const glm::quat qb(b.w, b.x, b.y, b.z);
-				jt.rotation = (s.interp == Interp::STEP) ? qa : glm::normalize(glm::slerp(qa, qb, f));
+				jt.rotation = glm::normalize((s.interp == Interp::STEP) ? qa : glm::slerp(qa, qb, f));
 			}
 			else
 			{
@@ -70,48 +98,311 @@ namespace bagel {
 		}
 	}
 
-	// Resolve joint `j`'s model-space matrix, recursing into its parent first. Order-independent:
-	// joints may be stored in any order; each global is computed once and memoized in outGlobals,
-	// with `done` tracking which are resolved. outGlobals is pre-sized, so the returned reference
-	// stays valid across the recursion.
-	static const glm::mat4& resolveJoint(const SkeletonData& skel, const Pose& localPose,
-										 std::vector<glm::mat4>& outGlobals, std::vector<char>& done, int j)
+	void sampleClip(const SkeletonData& skel, const AnimationClip& clip, float time, Pose& outPose)
+	{
+		sampleClipImpl(skel, clip, time, outPose, nullptr);
+	}
+
+	void sampleClip(const SkeletonData& skel, const AnimationClip& clip, float time, Pose& outPose,
+	                AnimEvalContext& ctx)
+	{
+		if (ctx.clip != &clip || ctx.cursors.size() != clip.samplers.size())
+		{
+			ctx.clip = &clip;
+			ctx.cursors.assign(clip.samplers.size(), 0);
+		}
+		sampleClipImpl(skel, clip, time, outPose, ctx.cursors.data());
+	}
+
+	// ---- Import-time key reduction --------------------------------------------------------------
+
+	// Interpolate between two keys exactly as sampleClipImpl does, so the reduction's error check
+	// measures what playback will actually produce.
+	static glm::vec4 lerpKey(AnimPath path, Interp interp, const glm::vec4& a, const glm::vec4& b, float f)
+	{
+		if (interp == Interp::STEP) return a;
+		if (path != AnimPath::ROTATION) return glm::mix(a, b, f);
+		const glm::quat q = glm::normalize(glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), f));
+		return glm::vec4(q.x, q.y, q.z, q.w);
+	}
+
+	// Distance between two key values in the units of `path`'s tolerance.
+	static float keyError(AnimPath path, const glm::vec4& a, const glm::vec4& b)
+	{
+		if (path != AnimPath::ROTATION) return glm::length(glm::vec3(a) - glm::vec3(b));
+		// Rotation angle between the two orientations, from their relative quaternion. 2*acos(dot)
+		// would be too coarse here: in float its smallest non-zero result is already ~0.04 degrees.
+		const glm::vec4 na = glm::normalize(a), nb = glm::normalize(b);
+		const glm::quat r = glm::conjugate(glm::quat(na.w, na.x, na.y, na.z)) * glm::quat(nb.w, nb.x, nb.y, nb.z);
+		return 2.0f * std::atan2(glm::length(glm::vec3(r.x, r.y, r.z)), std::abs(r.w));
+	}
+
+	static glm::i16vec4 quantizeRotation(const glm::vec4& q)
+	{
+		const glm::vec4 n = glm::clamp(glm::normalize(q), -1.0f, 1.0f) * 32767.0f;
+		return glm::i16vec4(glm::round(n));
+	}
+
+	AnimReduceStats reduceClip(AnimationClip& clip, const AnimReduceSettings& settings)
+	{
+		AnimReduceStats st;
+
+		// A sampler's tolerance comes from the path of the channel(s) driving it. Samplers shared
+		// by different paths (legal glTF, never seen in practice) are left as they are.
+		constexpr int UNUSED = -1, MIXED = -2;
+		std::vector<int> samplerPath(clip.samplers.size(), UNUSED);
+		for (const AnimChannel& ch : clip.channels)
+		{
+			if (ch.sampler < 0 || ch.sampler >= static_cast<int>(clip.samplers.size())) continue;
+			int& p = samplerPath[ch.sampler];
+			p = (p == UNUSED || p == static_cast<int>(ch.path)) ? static_cast<int>(ch.path) : MIXED;
+		}
+
+		for (size_t si = 0; si < clip.samplers.size(); ++si)
+		{
+			AnimSampler& s = clip.samplers[si];
+			const size_t n = s.times.size();
+			st.keysBefore  += n;
+			st.bytesBefore += n * sizeof(float) + s.valueCount() * sizeof(glm::vec4);
+
+			const bool reducible = samplerPath[si] >= 0 && s.interp != Interp::CUBICSPLINE &&
+			                       s.qrotations.empty() && n >= 2 && s.values.size() == n;
+			if (!reducible)
+			{
+				st.keysAfter  += n;
+				st.bytesAfter += n * sizeof(float) + (s.qrotations.empty() ? s.values.size() * sizeof(glm::vec4)
+				                                                           : s.qrotations.size() * sizeof(glm::i16vec4));
+				continue;
+			}
+
+			const AnimPath path = static_cast<AnimPath>(samplerPath[si]);
+			const bool quantize = path == AnimPath::ROTATION && settings.quantizeRotations;
+			const float tol = path == AnimPath::TRANSLATION ? settings.positionTolerance
+			                : path == AnimPath::ROTATION    ? settings.rotationTolerance
+			                                                : settings.scaleTolerance;
+
+			// Kept keys are what playback will interpolate between, so test against their stored
+			// (quantized) form; the reference is always the source value.
+			std::vector<glm::vec4> stored(s.values);
+			if (quantize)
+				for (size_t k = 0; k < n; ++k) stored[k] = glm::vec4(quantizeRotation(s.values[k])) * (1.0f / 32767.0f); // as AnimSampler::value decodes it
+
+			// Worst error of interpolating stored[a] -> stored[b] over the source keys between them.
+			auto spanError = [&](size_t a, size_t b) {
+				float worst = 0.0f;
+				const float d = s.times[b] - s.times[a];
+				for (size_t k = a + 1; k < b; ++k)
+				{
+					const float f = d > 0.0f ? (s.times[k] - s.times[a]) / d : 0.0f;
+					worst = std::max(worst, keyError(path, lerpKey(path, s.interp, stored[a], stored[b], f), s.values[k]));
+				}
+				return worst;
+			};
+
+			// Greedy forward pass: extend the span from the last kept key for as long as every key
+			// inside it is rebuilt within tolerance, then keep the last key that still fit.
+			std::vector<size_t> kept{ 0 };
+			size_t anchor = 0;
+			for (size_t end = 2; end < n; ++end)
+				if (spanError(anchor, end) > tol)
+				{
+					anchor = end - 1;
+					kept.push_back(anchor);
+				}
+			kept.push_back(n - 1);
+
+			// A track that never leaves its first value within tolerance collapses to one key
+			// (sampling clamps, so it then reads that key at every time).
+			bool constant = true;
+			for (size_t k = 1; k < n && constant; ++k)
+				constant = keyError(path, stored[0], s.values[k]) <= tol;
+			if (constant) kept.assign(1, 0);
+
+			// Measured error of the final track at every source key.
+			float err = 0.0f;
+			if (constant)
+				for (size_t k = 0; k < n; ++k) err = std::max(err, keyError(path, stored[0], s.values[k]));
+			else
+				for (size_t i = 0; i + 1 < kept.size(); ++i)
+				{
+					err = std::max(err, spanError(kept[i], kept[i + 1]));
+					err = std::max(err, keyError(path, stored[kept[i]], s.values[kept[i]]));
+				}
+			err = std::max(err, keyError(path, stored[kept.back()], s.values[kept.back()]));
+			float& maxErr = path == AnimPath::TRANSLATION ? st.maxPositionError
+			              : path == AnimPath::ROTATION    ? st.maxRotationError
+			                                              : st.maxScaleError;
+			maxErr = std::max(maxErr, err);
+
+			std::vector<float> times;
+			times.reserve(kept.size());
+			for (size_t k : kept) times.push_back(s.times[k]);
+			if (quantize)
+			{
+				s.qrotations.clear();
+				s.qrotations.reserve(kept.size());
+				for (size_t k : kept) s.qrotations.push_back(quantizeRotation(s.values[k]));
+				std::vector<glm::vec4>().swap(s.values);
+			}
+			else
+			{
+				std::vector<glm::vec4> values;
+				values.reserve(kept.size());
+				for (size_t k : kept) values.push_back(s.values[k]);
+				s.values.swap(values);
+			}
+			s.times.swap(times);
+
+			st.keysAfter  += s.times.size();
+			st.bytesAfter += s.times.size() * sizeof(float) +
+			                 (quantize ? s.qrotations.size() * sizeof(glm::i16vec4) : s.values.size() * sizeof(glm::vec4));
+		}
+		return st;
+	}
+
+	void buildJointOrder(SkeletonData& skel)
 	{
-		if (!done[j])
+		const int n = static_cast<int>(skel.jointCount());
+		skel.order.clear();
+		skel.order.reserve(n);
+
+		// Child lists in CSR form: children of j are childList[childStart[j] .. childStart[j+1]).
+		std::vector<int> childStart(n + 1, 0), childList(n);
+		std::vector<char> placed(n, 0);
+		for (int j = 0; j < n; ++j)
 		{
-			const int n = static_cast<int>(outGlobals.size());
-			const glm::mat4 local = (j < static_cast<int>(localPose.size())) ? localPose[j].matrix() : glm::mat4(1.0f);
 			const int p = skel.parents[j];
-			outGlobals[j] = (p >= 0 && p < n) ? resolveJoint(skel, localPose, outGlobals, done, p) * local : local;
-			done[j] = 1;
+			if (p >= 0 && p < n) ++childStart[p + 1];
+		}
+		for (int j = 0; j < n; ++j) childStart[j + 1] += childStart[j];
+		{
+			std::vector<int> fill(childStart.begin(), childStart.end() - 1);
+			for (int j = 0; j < n; ++j)
+			{
+				const int p = skel.parents[j];
+				if (p >= 0 && p < n) childList[fill[p]++] = j;
+			}
 		}
-		return outGlobals[j];
+
+		// Roots in index order, then breadth-first: `order` doubles as the BFS queue.
+		for (int j = 0; j < n; ++j)
+		{
+			const int p = skel.parents[j];
+			if (p < 0 || p >= n) { skel.order.push_back(j); placed[j] = 1; }
+		}
+		for (size_t head = 0; head < skel.order.size(); ++head)
+		{
+			const int j = skel.order[head];
+			for (int c = childStart[j]; c < childStart[j + 1]; ++c)
+				if (!placed[childList[c]]) { skel.order.push_back(childList[c]); placed[childList[c]] = 1; }
+		}
+
+		// Anything unreached sits in a parent cycle (malformed input). Keep it resolvable.
+		skel.orderedCount = static_cast<uint32_t>(skel.order.size());
+		for (int j = 0; j < n; ++j)
+			if (!placed[j]) skel.order.push_back(j);
 	}
 
 	void resolveGlobals(const SkeletonData& skel, const Pose& localPose, std::vector<glm::mat4>& outGlobals)
 	{
 		const int n = static_cast<int>(skel.jointCount());
-		outGlobals.assign(n, glm::mat4(1.0f));
-		std::vector<char> done(n, 0);
+		outGlobals.resize(n);
+		assert(static_cast<int>(skel.order.size()) == n && "SkeletonData::order missing — call buildJointOrder");
+		// Without an order, fall back to storage order (correct for skeletons already stored
+		// parent-first) rather than read past the end.
+		const int* order = static_cast<int>(skel.order.size()) == n ? skel.order.data() : nullptr;
+		const int  poseCount = static_cast<int>(localPose.size());
+		// Both fallbacks can read a parent before it is written this call; make that read identity.
+		if (!order || skel.orderedCount < static_cast<uint32_t>(n))
+			std::fill(outGlobals.begin(), outGlobals.end(), glm::mat4(1.0f));
 
-		for (int j = 0; j < n; ++j) resolveJoint(skel, localPose, outGlobals, done, j);
+		for (int k = 0; k < n; ++k)
+		{
+			const int j = order ? order[k] : k;
+			const glm::mat4 local = (j < poseCount) ? localPose[j].matrix() : glm::mat4(1.0f);
+			const int p = skel.parents[j];
+			outGlobals[j] = (p >= 0 && p < n) ? outGlobals[p] * local : local;
+		}
 	}
 
-	void globalsToPalette(const SkeletonData& skel, const std::vector<glm::mat4>& globals, glm::mat4* outPalette)
+	void globalsToPalette(const SkeletonData& skel, const std::vector<glm::mat4>& globals, PaletteMatrix* outPalette)
 	{
 		const int n = static_cast<int>(skel.jointCount());
 		for (int j = 0; j < n; ++j)
-			outPalette[j] = globals[j] * skel.inverseBind[j];
+			outPalette[j] = PaletteMatrix::fromMat4(globals[j] * skel.inverseBind[j]);
 	}
 
-	void resolvePalette(const SkeletonData& skel, const Pose& localPose, glm::mat4* outPalette)
+	void resolvePalette(const SkeletonData& skel, const Pose& localPose, PaletteMatrix* outPalette)
 	{
 		std::vector<glm::mat4> globals;
 		resolveGlobals(skel, localPose, globals);
 		globalsToPalette(skel, globals, outPalette);
 	}
 
-	BakedAnimation bakeClips(const SkeletonData& skel, const std::vector<AnimationClip>& clips, float fps)
+	void blendPoses(const Pose& a, const Pose& b, float w, Pose& out)
+	{
+		const size_t n = std::min(a.size(), b.size());
+		out.resize(a.size());
+		for (size_t j = 0; j < n; ++j)
+		{
+			const JointTransform& ja = a[j];
+			const JointTransform& jb = b[j];
+			// q and -q are the same rotation; flip b onto a's hemisphere so the lerp takes the short way.
+			const glm::quat qb = glm::dot(ja.rotation, jb.rotation) < 0.0f ? -jb.rotation : jb.rotation;
+			out[j].translation = glm::mix(ja.translation, jb.translation, w);
+			out[j].rotation    = glm::normalize(ja.rotation * (1.0f - w) + qb * w);
+			out[j].scale       = glm::mix(ja.scale, jb.scale, w);
+		}
+	}
+
+	void evaluateBlend(const SkeletonData& skel, const BlendInput* inputs, uint32_t count,
+	                   PosePool& pool, Pose& outPose)
+	{
+		assert(count <= MAX_BLEND_INPUTS && "evaluateBlend: too many inputs");
+		pool.reset();
+		float accumulated = 0.0f;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const BlendInput& in = inputs[i];
+			if (!in.clip || in.weight <= 0.0f) continue;
+			Pose& sampled = pool.acquire();
+			if (in.ctx) sampleClip(skel, *in.clip, in.time, sampled, *in.ctx);
+			else        sampleClip(skel, *in.clip, in.time, sampled);
+			// Running normalized average: each input takes its share of the weight seen so far.
+			const bool first = accumulated == 0.0f;
+			accumulated += in.weight;
+			if (first) outPose = sampled;
+			else       blendPoses(outPose, sampled, in.weight / accumulated, outPose);
+		}
+		if (accumulated == 0.0f) outPose = skel.restPose;
+	}
+
+	AnimBounds skinnedBounds(const std::vector<AnimBounds>& jointBounds, const PaletteMatrix* palette)
+	{
+		AnimBounds out;
+		for (size_t j = 0; j < jointBounds.size(); ++j)
+		{
+			const AnimBounds& b = jointBounds[j];
+			if (b.empty()) continue;
+			// Transform the box as centre + extent: the extent maps through |rotation*scale|.
+			const glm::vec3 c = 0.5f * (b.min + b.max);
+			const glm::vec3 e = 0.5f * (b.max - b.min);
+			const PaletteMatrix& m = palette[j];
+			glm::vec3 pc, pe;
+			for (int r = 0; r < 3; ++r)
+			{
+				const glm::vec4& row = m.rows[r];
+				pc[r] = row.x * c.x + row.y * c.y + row.z * c.z + row.w;
+				pe[r] = std::abs(row.x) * e.x + std::abs(row.y) * e.y + std::abs(row.z) * e.z;
+			}
+			out.grow(pc - pe);
+			out.grow(pc + pe);
+		}
+		return out;
+	}
+
+	BakedAnimation bakeClips(const SkeletonData& skel, const std::vector<AnimationClip>& clips, float fps,
+	                         const std::vector<AnimBounds>* jointBounds)
 	{
 		BakedAnimation out;
 		out.jointCount = skel.jointCount();
@@ -128,21 +419,50 @@ namespace bagel {
 			out.clipFrameCount[c] = frames;
 			totalFrames += frames;
 		}
-		out.matrices.assign(static_cast<size_t>(totalFrames) * out.jointCount, glm::mat4(1.0f));
+		out.matrices.assign(static_cast<size_t>(totalFrames) * out.jointCount, PaletteMatrix::fromMat4(glm::mat4(1.0f)));
 		if (out.jointCount == 0) return out;
+		const bool bounds = jointBounds && jointBounds->size() == out.jointCount;
+		if (bounds) out.frameBounds.resize(totalFrames);
 
-		Pose pose;
-		for (size_t c = 0; c < clips.size(); ++c)
-			for (uint32_t f = 0; f < out.clipFrameCount[c]; ++f)
+		// Every frame row is independent (fixed time in, fixed matrices out), so the rows are split
+		// across the worker pool. Each worker owns its pose/globals/cursor scratch; a chunk is a
+		// contiguous run of rows, sampled in increasing time, so the cursor context still turns each
+		// keyframe lookup into a step or two forward. The matrices come out identical to a serial
+		// bake — only which thread writes a row changes.
+		struct BakeScratch {
+			Pose                   pose;
+			std::vector<glm::mat4> globals;
+			AnimEvalContext        ctx;
+		};
+		WorkerPool& pool = WorkerPool::get();
+		std::vector<BakeScratch> scratch(pool.threadCount());
+		constexpr uint32_t ROWS_PER_CHUNK = 32;
+
+		pool.parallelFor(totalFrames, ROWS_PER_CHUNK, [&](uint32_t begin, uint32_t end, uint32_t worker) {
+			BakeScratch& s = scratch[worker];
+			// Clip owning the first row of the chunk; later rows advance it as they cross bases.
+			size_t c = std::upper_bound(out.clipFrameBase.begin(), out.clipFrameBase.end(), begin) - out.clipFrameBase.begin() - 1;
+			for (uint32_t row = begin; row < end; ++row)
 			{
-				const float t = static_cast<float>(f) / out.fps;
-				sampleClip(skel, clips[c], t, pose);
-				resolvePalette(skel, pose, &out.matrices[static_cast<size_t>(out.clipFrameBase[c] + f) * out.jointCount]);
+				while (row >= out.clipFrameBase[c] + out.clipFrameCount[c]) ++c;
+				const float t = static_cast<float>(row - out.clipFrameBase[c]) / out.fps;
+				sampleClip(skel, clips[c], t, s.pose, s.ctx);
+				resolveGlobals(skel, s.pose, s.globals);
+				globalsToPalette(skel, s.globals, &out.matrices[static_cast<size_t>(row) * out.jointCount]);
+				if (bounds) out.frameBounds[row] = skinnedBounds(*jointBounds, &out.matrices[static_cast<size_t>(row) * out.jointCount]);
 			}
+		});
 		return out;
 	}
 
 	void solveTwoBoneIK(const SkeletonData& skel, const TwoBoneIK& ik, Pose& pose)
+	{
+		std::vector<glm::mat4> g;
+		solveTwoBoneIK(skel, ik, pose, g);
+	}
+
+	void solveTwoBoneIK(const SkeletonData& skel, const TwoBoneIK& ik, Pose& pose,
+	                    std::vector<glm::mat4>& g)
 	{
 		const int n = static_cast<int>(skel.jointCount());
 		if (ik.thigh < 0 || ik.shin < 0 || ik.foot < 0) return;
@@ -166,7 +486,6 @@ namespace bagel {
 		};
 
 		const float eps = 1e-4f;
-		std::vector<glm::mat4> g;
 		resolveGlobals(skel, pose, g);
 		glm::vec3 a = glm::vec3(g[ik.thigh][3]);
 		glm::vec3 b = glm::vec3(g[ik.shin][3]);
@@ -228,8 +547,11 @@ namespace bagel {
 		}
 	}
 
-	void applyManualPose(const SkeletonData& skel, const Pose& editPose,
-	                     const std::vector<IKSetup>& iks, Pose& outPose)
+	// Shared body of both applyManualPose overloads: `g` holds the base-pose globals, `ikGlobals`
+	// is handed to every solve.
+	static void applyManualPoseInto(const SkeletonData& skel, const Pose& editPose,
+	                                const std::vector<IKSetup>& iks, Pose& outPose,
+	                                std::vector<glm::mat4>& g, std::vector<glm::mat4>& ikGlobals)
 	{
 		outPose = editPose;
 		const int n = static_cast<int>(skel.jointCount());
@@ -240,7 +562,6 @@ namespace bagel {
 
 		// Goal/pole are joints — read their model-space positions from the base pose once, so all
 		// setups solve against the same reference (matches the original per-frame palette pass).
-		std::vector<glm::mat4> g;
 		resolveGlobals(skel, outPose, g);
 		for (const IKSetup& s : iks)
 		{
@@ -251,12 +572,25 @@ namespace bagel {
 			ik.goalModelSpace = glm::vec3(g[s.goalJoint][3]);
 			ik.poleModelSpace = glm::vec3(g[s.poleJoint][3]);
 			ik.weight = s.weight;
-			solveTwoBoneIK(skel, ik, outPose);
+			solveTwoBoneIK(skel, ik, outPose, ikGlobals);
 		}
 	}
 
+	void applyManualPose(const SkeletonData& skel, const Pose& editPose,
+	                     const std::vector<IKSetup>& iks, Pose& outPose)
+	{
+		std::vector<glm::mat4> g, ikGlobals;
+		applyManualPoseInto(skel, editPose, iks, outPose, g, ikGlobals);
+	}
+
+	void applyManualPose(const SkeletonData& skel, const Pose& editPose,
+	                     const std::vector<IKSetup>& iks, ManualPoseScratch& s)
+	{
+		applyManualPoseInto(skel, editPose, iks, s.pose, s.baseGlobals, s.globals);
+	}
+
 	void evaluatePoseLive(const SkeletonData& skel, const AnimationClip& clip, float time,
-	                      const std::vector<TwoBoneIK>& iks, glm::mat4* outPalette)
+	                      const std::vector<TwoBoneIK>& iks, PaletteMatrix* outPalette)
 	{
 		Pose pose;
 		sampleClip(skel, clip, time, pose);
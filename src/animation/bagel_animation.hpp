@@ -1,12 +1,17 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cassert>
 #include <cstdint>
+#include <limits>
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+#include "engine/bagel_engine_config.hpp" // cfg::kAnim* reduction defaults
 
 // Skeletal animation core: data model + the shared pose->palette pipeline.
 //
@@ -19,7 +24,7 @@
 //                           resolveGlobals  (hierarchy walk: local -> model-space)
 //                                  │  ◄── world-space IK can edit globals here
 //                                  ▼
-//                           globalsToPalette (× inverseBind)  ──► glm::mat4 palette
+//                           globalsToPalette (× inverseBind)  ──► PaletteMatrix (3x4) palette
 //                                  │
 //                                  ▼
 //        baked once at load  ──► resident SSBO region        (static clips)
@@ -47,13 +52,16 @@ namespace bagel {
 	// Skeleton in joint-index space (0..jointCount-1). This is the index space the per-vertex
 	// JOINTS_0 values and the GPU palette both use. restPose[j] is the bind/rest local TRS;
 	// parents[j] is the parent joint index or -1 for a root; inverseBind[j] is the glTF inverse
-	// bind matrix. Joint order is glTF skin.joints order; resolveGlobals is order-independent
-	// (it resolves parents on demand), so no topological sort or vertex remap is required.
+	// bind matrix. Joint storage order stays glTF skin.joints order, so no vertex remap is needed;
+	// `order` lists the same indices with every parent ahead of its children. It is computed once
+	// (buildJointOrder) when the skin is parsed, and resolveGlobals walks it front to back.
 	struct SkeletonData {
 		std::vector<JointTransform> restPose;
 		std::vector<glm::mat4>      inverseBind;
 		std::vector<int>            parents;
 		std::vector<std::string>    names;      // glTF node name per joint (may be empty)
+		std::vector<int>            order;      // joint indices, parent-before-child (buildJointOrder)
+		uint32_t orderedCount = 0;              // leading entries of `order` reached from a root; the rest sit in a parent cycle
 		uint32_t jointCount() const { return static_cast<uint32_t>(inverseBind.size()); }
 		bool     empty()      const { return inverseBind.empty(); }
 	};
@@ -66,10 +74,21 @@ namespace bagel {
 	// A keyframe track. `times` are input times in seconds. `values` are outputs: xyz for
 	// translation/scale, xyzw quaternion for rotation. CUBICSPLINE stores 3 values per key
 	// (in-tangent, value, out-tangent), so values.size() == 3 * times.size() in that mode.
+	// After reduceClip a rotation track may instead hold its keys quantized in `qrotations`
+	// (snorm16 xyzw, 8 bytes a key instead of 16) with `values` left empty; read keys through
+	// value(), which decodes either form. A decoded rotation is only unit length to within the
+	// quantization step: the sampler normalizes after interpolating, so value() doesn't.
 	struct AnimSampler {
-		std::vector<float>     times;
-		std::vector<glm::vec4> values;
-		Interp                 interp = Interp::LINEAR;
+		std::vector<float>        times;
+		std::vector<glm::vec4>    values;
+		std::vector<glm::i16vec4> qrotations;
+		Interp                    interp = Interp::LINEAR;
+
+		size_t valueCount() const { return qrotations.empty() ? values.size() : qrotations.size(); }
+		glm::vec4 value(size_t i) const {
+			if (qrotations.empty()) return values[i];
+			return glm::vec4(qrotations[i]) * (1.0f / 32767.0f);
+		}
 	};
 
 	// Binds a sampler to a target (joint, path). Channels targeting non-joint nodes or morph
@@ -88,23 +107,156 @@ namespace bagel {
 		std::vector<AnimChannel> channels;
 	};
 
+	// Import-time key reduction (reduceClip). A LINEAR or STEP key is dropped when interpolating
+	// between its kept neighbours reproduces it within the tolerance of its path: model units for
+	// translation and scale, radians of rotation angle. CUBICSPLINE tracks are left untouched.
+	// Defaults are the engine config's import tolerances.
+	struct AnimReduceSettings {
+		float positionTolerance = cfg::kAnimPositionTolerance;
+		float rotationTolerance = glm::radians(cfg::kAnimRotationToleranceDegrees);
+		float scaleTolerance    = cfg::kAnimScaleTolerance;
+		bool  quantizeRotations = cfg::kAnimQuantizeRotations; // store rotation keys as snorm16 quaternions (qrotations)
+	};
+	// What reduceClip did to one clip. Errors are the worst deviation, over every ORIGINAL key time,
+	// of the reduced (and quantized) track from the source values.
+	struct AnimReduceStats {
+		size_t keysBefore  = 0;
+		size_t keysAfter   = 0;
+		size_t bytesBefore = 0; // times + values storage
+		size_t bytesAfter  = 0;
+		float  maxPositionError = 0.0f;
+		float  maxRotationError = 0.0f; // radians
+		float  maxScaleError    = 0.0f;
+		float  ratio() const { return bytesAfter > 0 ? static_cast<float>(bytesBefore) / static_cast<float>(bytesAfter) : 1.0f; }
+	};
+	// Drop keys that interpolation rebuilds within tolerance and (optionally) quantize rotations.
+	// Sampling the result matches the source within the stated error at every source key time.
+	AnimReduceStats reduceClip(AnimationClip& clip, const AnimReduceSettings& settings);
+
+	// Playback cursors for sampling one clip repeatedly. cursors[s] is the key index that bracketed
+	// sampler s on the previous call; when time moves forward the next lookup walks on from there
+	// (amortized O(1) per channel), and a backward or long jump falls back to a binary search.
+	// One context per playing clip instance — the baker keeps one per clip, a live rig one per
+	// entity. Rebinds (and resets) itself when handed a different clip.
+	struct AnimEvalContext {
+		const AnimationClip*  clip = nullptr;
+		std::vector<uint32_t> cursors;
+	};
+
+	// Fill skel.order from skel.parents: roots first, then breadth-first down the hierarchy. Call
+	// once after the parents are known (the glTF loader does it in parseSkin). A parent index out of
+	// range counts as a root; joints caught in a parent cycle are appended last in index order, after
+	// the first skel.orderedCount entries.
+	void buildJointOrder(SkeletonData& skel);
+
 	// ---- Shared pose pipeline ----------------------------------------------------------------
 
 	// Sample `clip` at `time` (seconds, already wrapped/clamped by the caller) into `outPose`.
 	// Starts from skel.restPose; joints with no channel keep their rest transform. outPose is
-	// resized to skel.jointCount().
+	// resized to skel.jointCount(). Keyframes are located by binary search.
 	void sampleClip(const SkeletonData& skel, const AnimationClip& clip, float time, Pose& outPose);
 
-	// Hierarchy walk: local pose -> per-joint model-space (global) matrices. Order-independent
-	// (parents resolved on demand). This is the seam world-space IK edits before palette build.
+	// Same, but reuses (and advances) the per-sampler cursors in `ctx`. Produces exactly the same
+	// pose as the context-free overload; only the keyframe lookup is cheaper for forward playback.
+	void sampleClip(const SkeletonData& skel, const AnimationClip& clip, float time, Pose& outPose,
+	                AnimEvalContext& ctx);
+
+	// Hierarchy walk: local pose -> per-joint model-space (global) matrices. One forward pass over
+	// skel.order, so each parent is final before its children read it. Joints in a parent cycle (or
+	// every joint, if skel.order is missing) read identity for any parent not yet resolved rather
+	// than a stale matrix. outGlobals is resized to skel.jointCount() and reused in place, so a warm
+	// buffer costs no allocation. This is the seam world-space IK edits before palette build.
 	void resolveGlobals(const SkeletonData& skel, const Pose& localPose, std::vector<glm::mat4>& outGlobals);
 
-	// palette[j] = globals[j] * inverseBind[j]. `outPalette` must hold skel.jointCount() entries.
-	// This is exactly what the GPU reads as palette[animBase + j].
-	void globalsToPalette(const SkeletonData& skel, const std::vector<glm::mat4>& globals, glm::mat4* outPalette);
+	// One skinning-palette entry as stored in the palette SSBO: the top three ROWS of an affine
+	// joint matrix (row i = (m[0][i], m[1][i], m[2][i], m[3][i])). Rigid skinning never needs the
+	// bottom row — it is always (0,0,0,1) — so it is dropped: 48 bytes instead of a mat4's 64,
+	// a quarter less palette memory and bandwidth. shaders/palette.glsl rebuilds the mat4.
+	struct PaletteMatrix {
+		glm::vec4 rows[3];
+
+		static PaletteMatrix fromMat4(const glm::mat4& m) {
+			return { { glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]),
+			           glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]),
+			           glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]) } };
+		}
+		glm::mat4 toMat4() const {
+			return glm::transpose(glm::mat4(rows[0], rows[1], rows[2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+		}
+	};
+	static_assert(sizeof(PaletteMatrix) == 48, "PaletteMatrix must match the GLSL palette row layout");
+
+	// Axis-aligned box; default-constructed empty (min > max) so the first grow() sets it.
+	struct AnimBounds {
+		glm::vec3 min{  std::numeric_limits<float>::max() };
+		glm::vec3 max{ -std::numeric_limits<float>::max() };
+		bool empty() const { return min.x > max.x; }
+		void grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+		void grow(const AnimBounds& b) { if (!b.empty()) { min = glm::min(min, b.min); max = glm::max(max, b.max); } }
+	};
+
+	// palette[j] = globals[j] * inverseBind[j], packed to 3x4. `outPalette` must hold
+	// skel.jointCount() entries. This is exactly what the GPU reads as palette[animBase + j].
+	void globalsToPalette(const SkeletonData& skel, const std::vector<glm::mat4>& globals, PaletteMatrix* outPalette);
 
 	// Convenience: localPose -> palette (resolveGlobals + globalsToPalette).
-	void resolvePalette(const SkeletonData& skel, const Pose& localPose, glm::mat4* outPalette);
+	void resolvePalette(const SkeletonData& skel, const Pose& localPose, PaletteMatrix* outPalette);
+
+	// Conservative model-space bounds of a skinned mesh posed by `palette`. jointBounds[j] is the
+	// bind-space box of the vertices joint j influences (empty if none). A skinned vertex is a
+	// weighted average of palette[j] * v over its joints, and every such term lies in joint j's
+	// transformed box, so the union of those boxes contains the deformed mesh. One box transform
+	// per joint — cheap enough to run for every baked frame and every live pose.
+	AnimBounds skinnedBounds(const std::vector<AnimBounds>& jointBounds, const PaletteMatrix* palette);
+
+	// ---- Runtime blending ---------------------------------------------------------------------
+
+	// Most clips one blend evaluation mixes (and Pose buffers a PosePool hands out per evaluation).
+	static constexpr uint32_t MAX_BLEND_INPUTS = 4;
+
+	// Mix two poses joint by joint: w = 0 gives `a`, w = 1 gives `b`. Translation and scale lerp,
+	// rotation nlerps along the shorter arc. `out` may alias `a`.
+	void blendPoses(const Pose& a, const Pose& b, float w, Pose& out);
+
+	// Fixed set of Pose buffers recycled every evaluation. acquire() hands out the next buffer,
+	// reset() returns all of them; the buffers keep their capacity, so once each has held a full
+	// pose the pool allocates nothing. One pool per worker thread — it is not thread-safe.
+	class PosePool {
+	public:
+		explicit PosePool(uint32_t capacity = MAX_BLEND_INPUTS) : poses(capacity) {}
+		Pose& acquire() {
+			assert(used < poses.size() && "PosePool exhausted");
+			return poses[used++];
+		}
+		void reset() { used = 0; }
+	private:
+		std::vector<Pose> poses;
+		uint32_t          used = 0;
+	};
+
+	// One weighted clip input to evaluateBlend. `ctx` carries the input's keyframe cursors across
+	// frames (owned by whoever owns the layer); null falls back to binary search.
+	struct BlendInput {
+		const AnimationClip* clip   = nullptr;
+		float                time   = 0.0f;   // seconds, already wrapped/clamped by the caller
+		float                weight = 0.0f;
+		AnimEvalContext*     ctx    = nullptr;
+	};
+
+	// Sample every input with weight > 0 into a pool pose and fold them into `outPose` as a
+	// normalized weighted average (weights need not sum to 1). With no contributing input
+	// `outPose` is the rest pose. Resets `pool` first; at most MAX_BLEND_INPUTS inputs.
+	void evaluateBlend(const SkeletonData& skel, const BlendInput* inputs, uint32_t count,
+	                   PosePool& pool, Pose& outPose);
+
+	// Per-thread working set of a blend evaluation through to its palette. Reused frame to frame,
+	// so evaluating the same rigs again costs no allocation.
+	struct BlendScratch {
+		PosePool                   pool;
+		Pose                       pose;
+		std::vector<glm::mat4>     globals;
+		std::vector<PaletteMatrix> palette;
+	};
 
 	// ---- Bake (static clips) -----------------------------------------------------------------
 
@@ -113,7 +265,8 @@ namespace bagel {
 	//   matrices[ (clipFrameBase[c] + frame) * jointCount + j ].
 	// A draw selects a row with frameOffset(clip, frame) and pushes it as animBaseOffset.
 	struct BakedAnimation {
-		std::vector<glm::mat4> matrices;        // ready to upload into the resident palette SSBO
+		std::vector<PaletteMatrix> matrices;    // ready to upload into the resident palette SSBO
+		std::vector<AnimBounds>    frameBounds; // per frame row: skinnedBounds of that row (if requested)
 		std::vector<uint32_t>  clipFrameBase;   // per clip: first frame row (in frames)
 		std::vector<uint32_t>  clipFrameCount;  // per clip: baked frame count
 		uint32_t               jointCount = 0;
@@ -126,9 +279,12 @@ namespace bagel {
 		size_t   matrixCount() const { return matrices.size(); }
 	};
 
-	// Bake every clip at `fps`. Done once at load; the result feeds the resident palette SSBO.
+	// Bake every clip at `fps`. Done once at load, with the frame rows spread across WorkerPool;
+	// the result is identical to a serial bake and feeds the resident palette SSBO.
 	// Dynamic/IK entities bypass this and write their palette per frame (see evaluatePoseLive).
-	BakedAnimation bakeClips(const SkeletonData& skel, const std::vector<AnimationClip>& clips, float fps = 60.0f);
+	// With `jointBounds` (see skinnedBounds) each frame row also gets its model-space bounds.
+	BakedAnimation bakeClips(const SkeletonData& skel, const std::vector<AnimationClip>& clips, float fps = 60.0f,
+	                         const std::vector<AnimBounds>* jointBounds = nullptr);
 
 	// ---- Dynamic / generative / inverse kinematics seam --------------------------------------
 	//
@@ -164,6 +320,9 @@ namespace bagel {
 	// Solve `ik` (analytic two-bone) and write corrected local rotations for thigh/shin into `pose`,
 	// blended by ik.weight. Goal/pole are positions in the SAME (model) space as resolveGlobals.
 	void solveTwoBoneIK(const SkeletonData& skel, const TwoBoneIK& ik, Pose& pose);
+	// Same, resolving into caller-owned `scratchGlobals` instead of a fresh vector per call.
+	void solveTwoBoneIK(const SkeletonData& skel, const TwoBoneIK& ik, Pose& pose,
+	                    std::vector<glm::mat4>& scratchGlobals);
 
 	// Resolve a manual (hand-authored) pose: copy `editPose`, then apply every valid IKSetup on top.
 	// Each setup reads its goal/pole joint positions from the globals of the base pose, then solves a
@@ -173,10 +332,23 @@ namespace bagel {
 	void applyManualPose(const SkeletonData& skel, const Pose& editPose,
 	                     const std::vector<IKSetup>& iks, Pose& outPose);
 
+	// Per-thread scratch for the batched manual-pose path (Application::updateAnimation). Every
+	// buffer keeps its capacity between frames, so a steady manual-pose frame allocates nothing.
+	struct ManualPoseScratch {
+		Pose                       pose;        // editPose + IK
+		std::vector<glm::mat4>     baseGlobals; // goal/pole reference (pre-IK pose)
+		std::vector<glm::mat4>     globals;     // IK working set, then the final resolve
+		std::vector<PaletteMatrix> palette;
+	};
+
+	// applyManualPose into `s.pose` using only the scratch buffers.
+	void applyManualPose(const SkeletonData& skel, const Pose& editPose,
+	                     const std::vector<IKSetup>& iks, ManualPoseScratch& s);
+
 	// Live (dynamic) evaluation entry point for generative animation and IK. Samples `clip` at
 	// `time`, applies each IK request in order, then resolves straight to a palette the caller
 	// uploads into the dynamic SSBO region for this frame. Bypasses the baked buffer entirely.
 	// `outPalette` must hold skel.jointCount() entries.
 	void evaluatePoseLive(const SkeletonData& skel, const AnimationClip& clip, float time,
-	                      const std::vector<TwoBoneIK>& iks, glm::mat4* outPalette);
+	                      const std::vector<TwoBoneIK>& iks, PaletteMatrix* outPalette);
 }
@@ -1,5 +1,6 @@
 #include "animation/bagel_skin_manager.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -22,48 +23,216 @@ namespace bagel {
 
 		paletteBuffer = std::make_unique<BGLBuffer>(
 			device,
-			sizeof(glm::mat4),
+			sizeof(PaletteMatrix),
 			MAX_PALETTE_MATRICES,
 			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 		paletteBuffer->map();
 		descriptorManager.storePaletteBuffer(paletteBuffer->descriptorInfo());
+
+		std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> instanceInfos;
+		for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			instanceBuffers[i] = std::make_unique<BGLBuffer>(
+				device,
+				sizeof(SkinInstance),
+				MAX_SKIN_INSTANCES * INSTANCE_PASS_COUNT,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			instanceBuffers[i]->map();
+			instanceInfos[i] = instanceBuffers[i]->descriptorInfo();
+		}
+		descriptorManager.storeSkinInstanceBuffers(instanceInfos);
 	}
 
 	uint32_t BGLSkinManager::uploadInfluences(const void* data, uint32_t vertexCount)
 	{
-		assert(skinCursor + vertexCount <= MAX_SKIN_VERTICES && "skin influence buffer overflow");
-		const uint32_t base = skinCursor;
+		uint32_t base = skinAlloc.allocate(vertexCount);
+		if (base == INVALID_BASE && compactHandler)
+		{
+			compactHandler();
+			base = skinAlloc.allocate(vertexCount);
+		}
+		if (base == INVALID_BASE) return INVALID_BASE;
 		skinBuffer->writeToBuffer(const_cast<void*>(data),
 			static_cast<VkDeviceSize>(vertexCount) * INFLUENCE_STRIDE,
 			static_cast<VkDeviceSize>(base) * INFLUENCE_STRIDE);
 		skinBuffer->flush();
-		skinCursor += vertexCount;
 		return base;
 	}
 
-	uint32_t BGLSkinManager::uploadPalette(const glm::mat4* data, uint32_t matrixCount)
+	void BGLSkinManager::releaseInfluences(uint32_t base)
+	{
+		skinAlloc.release(base);
+	}
+
+	void BGLSkinManager::enableRestVertices(BGLBindlessDescriptorManager& descriptorManager)
+	{
+		if (restBuffer) return;
+		// 1M verts * 64B = 64 MB, only read by compute pre-skinning.
+		restBuffer = std::make_unique<BGLBuffer>(
+			device,
+			REST_VERTEX_STRIDE,
+			MAX_SKIN_VERTICES,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		restBuffer->map();
+		descriptorManager.storeRestVertexBuffer(restBuffer->descriptorInfo());
+	}
+
+	void BGLSkinManager::copyRestVertices(VkBuffer vertexBuffer, uint32_t base, uint32_t vertexCount)
+	{
+		if (!restBuffer || base == INVALID_BASE) return;
+		assert(base + vertexCount <= MAX_SKIN_VERTICES && "rest vertices outside the skin buffer");
+		device.copyBuffer(vertexBuffer, restBuffer->getBuffer(),
+			static_cast<VkDeviceSize>(vertexCount) * REST_VERTEX_STRIDE,
+			0, static_cast<VkDeviceSize>(base) * REST_VERTEX_STRIDE);
+		restBuffer->invalidate(); // the copy has completed; compaction memmoves these bytes on the host
+	}
+
+	void BGLSkinManager::uploadRestVertices(uint32_t base, const void* vertices, uint32_t vertexCount)
 	{
-		const uint32_t base = reservePalette(matrixCount);
+		if (!restBuffer || base == INVALID_BASE) return;
+		assert(base + vertexCount <= MAX_SKIN_VERTICES && "rest vertices outside the skin buffer");
+		restBuffer->writeToBuffer(const_cast<void*>(vertices),
+			static_cast<VkDeviceSize>(vertexCount) * REST_VERTEX_STRIDE,
+			static_cast<VkDeviceSize>(base) * REST_VERTEX_STRIDE);
+		restBuffer->flush();
+	}
+
+	uint32_t BGLSkinManager::uploadPalette(const PaletteMatrix* data, uint32_t matrixCount)
+	{
+		uint32_t base = reservePalette(matrixCount);
+		if (base == INVALID_BASE && compactHandler)
+		{
+			compactHandler();
+			base = reservePalette(matrixCount);
+		}
+		if (base == INVALID_BASE) return INVALID_BASE;
 		writePalette(base, data, matrixCount);
 		return base;
 	}
 
 	uint32_t BGLSkinManager::reservePalette(uint32_t matrixCount)
 	{
-		assert(paletteCursor + matrixCount <= MAX_PALETTE_MATRICES && "joint palette buffer overflow");
-		const uint32_t base = paletteCursor;
-		paletteCursor += matrixCount;
-		return base;
+		return paletteAlloc.allocate(matrixCount);
+	}
+
+	void BGLSkinManager::releasePalette(uint32_t base)
+	{
+		paletteAlloc.release(base);
+	}
+
+	void BGLSkinManager::writePalette(uint32_t base, const PaletteMatrix* data, uint32_t count)
+	{
+		stagePalette(base, data, count);
+		flushPalette();
+	}
+
+	void BGLSkinManager::stagePalette(uint32_t base, const PaletteMatrix* data, uint32_t count)
+	{
+		assert(base + count <= MAX_PALETTE_MATRICES && "writePalette outside the palette buffer");
+		paletteBuffer->writeToBuffer(const_cast<PaletteMatrix*>(data),
+			static_cast<VkDeviceSize>(count) * sizeof(PaletteMatrix),
+			static_cast<VkDeviceSize>(base) * sizeof(PaletteMatrix));
 	}
 
-	void BGLSkinManager::writePalette(uint32_t base, const glm::mat4* data, uint32_t count)
+	void BGLSkinManager::flushPalette()
 	{
-		assert(base + count <= paletteCursor && "writePalette outside a reserved region");
-		paletteBuffer->writeToBuffer(const_cast<glm::mat4*>(data),
-			static_cast<VkDeviceSize>(count) * sizeof(glm::mat4),
-			static_cast<VkDeviceSize>(base) * sizeof(glm::mat4));
 		paletteBuffer->flush();
 	}
 
+	void BGLSkinManager::beginInstanceFrame(uint32_t frameIndex)
+	{
+		assert(frameIndex < BGLSwapChain::MAX_FRAMES_IN_FLIGHT);
+		instanceFrame = frameIndex;
+		instanceCursor.fill(0);
+	}
+
+	uint32_t BGLSkinManager::pushInstances(uint32_t pass, const SkinInstance* data, uint32_t count)
+	{
+		assert(pass < INSTANCE_PASS_COUNT);
+		if (count == 0 || count > instancesLeft(pass)) return INVALID_BASE;
+		const uint32_t first = pass * MAX_SKIN_INSTANCES + instanceCursor[pass];
+		BGLBuffer& buffer = *instanceBuffers[instanceFrame];
+		buffer.writeToBuffer(const_cast<SkinInstance*>(data),
+			static_cast<VkDeviceSize>(count) * sizeof(SkinInstance),
+			static_cast<VkDeviceSize>(first) * sizeof(SkinInstance));
+		buffer.flush();
+		instanceCursor[pass] += count;
+		return first;
+	}
+
+	void BGLSkinManager::compactInfluences(std::vector<RangeAllocator::Move>& moves)
+	{
+		const size_t first = moves.size();
+		skinAlloc.compact(moves);
+		moveBlocks(*skinBuffer, INFLUENCE_STRIDE, moves, first);
+		if (restBuffer) moveBlocks(*restBuffer, REST_VERTEX_STRIDE, moves, first);
+	}
+
+	void BGLSkinManager::compactPalette(std::vector<RangeAllocator::Move>& moves)
+	{
+		const size_t first = moves.size();
+		paletteAlloc.compact(moves);
+		moveBlocks(*paletteBuffer, sizeof(PaletteMatrix), moves, first);
+	}
+
+	void BGLSkinManager::moveBlocks(BGLBuffer& buffer, uint32_t stride, const std::vector<RangeAllocator::Move>& moves, size_t first)
+	{
+		if (first == moves.size()) return;
+		char* mapped = static_cast<char*>(buffer.getMappedMemory());
+		// Ascending order with every block moving down: a block's destination can only overlap its
+		// own old bytes or space already vacated, so memmove front to back is safe.
+		for (size_t i = first; i < moves.size(); ++i)
+		{
+			const RangeAllocator::Move& m = moves[i];
+			std::memmove(mapped + static_cast<size_t>(m.to) * stride,
+			             mapped + static_cast<size_t>(m.from) * stride,
+			             static_cast<size_t>(m.count) * stride);
+		}
+		buffer.flush();
+	}
+
+	// *************** SkinInstanceBatcher *********************
+
+	void SkinInstanceBatcher::add(const Model* model, const SkinInstance& instance)
+	{
+		pending.push_back({ model, static_cast<uint32_t>(added.size()) });
+		added.push_back(instance);
+	}
+
+	uint32_t SkinInstanceBatcher::upload(BGLSkinManager& skinManager, uint32_t pass)
+	{
+		batchList.clear();
+		if (pending.empty()) return 0;
+
+		// Group by Model; the index keeps the order within a group stable from frame to frame.
+		std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+			return a.model != b.model ? a.model < b.model : a.index < b.index;
+		});
+		instances.clear();
+		for (const Pending& p : pending) {
+			if (batchList.empty() || batchList.back().model != p.model)
+				batchList.push_back({ p.model, static_cast<uint32_t>(instances.size()), 0 });
+			batchList.back().instanceCount++;
+			instances.push_back(added[p.index]);
+		}
+
+		// Over budget: keep whole groups while they fit, cut the first one that does not and drop
+		// the groups after it.
+		const uint32_t total  = static_cast<uint32_t>(instances.size());
+		const uint32_t budget = std::min(total, skinManager.instancesLeft(pass));
+		if (budget < total) {
+			while (!batchList.empty() && batchList.back().firstInstance >= budget) batchList.pop_back();
+			if (!batchList.empty())
+				batchList.back().instanceCount = budget - batchList.back().firstInstance;
+		}
+		if (batchList.empty()) return total;
+
+		const uint32_t base = skinManager.pushInstances(pass, instances.data(), budget);
+		assert(base != BGLSkinManager::INVALID_BASE);
+		for (Batch& b : batchList) b.firstInstance += base;
+		return total - budget;
+	}
+
 } // namespace bagel
@@ -3,54 +3,190 @@
 #include "engine/bagel_engine_device.hpp"
 #include "bagel_buffer.hpp"
 #include "engine/bagel_descriptors.hpp"
+#include "animation/bagel_animation.hpp"
+#include "bagel_range_allocator.hpp"
+#include "bagel_frame_info.hpp"
 
 #include <glm/glm.hpp>
+#include <array>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace bagel {
 
+	struct Model;
+
+	// One skinned instance as the instanced vertex shaders read it (skinInstances.v[gl_InstanceIndex]
+	// in shaders/palette.glsl). std430: the mat4 then four scalars, 80 bytes.
+	struct SkinInstance {
+		glm::mat4 modelMatrix{ 1.0f };
+		uint32_t  animBaseOffset  = 0;    // palette base of the current row (AnimationPlaybackComponent::animBaseOffset)
+		uint32_t  animNextOffset  = 0;    // palette base of the next baked row
+		float     animFrameBlend  = 0.0f; // weight of that next row
+		uint32_t  materialRowBase = 0;    // skinBase + skinIndex*numSlots
+	};
+	static_assert(sizeof(SkinInstance) == 80, "SkinInstance must match the std430 struct in palette.glsl");
+
 	// Owns the two resident SSBOs for skeletal skinning, both host-visible/mapped and
-	// bump-allocated as skinned models load (mirrors BGLMaterialManager's skin table):
+	// sub-allocated (RangeAllocator) as skinned models load and entities come and go:
 	//
 	//   SKIN buffer    — per-vertex influences (8 bytes: 4×u8 joint index + 4×u8 unorm weight).
 	//                    Read by the skinned vertex shader as v[skinVertexBase + gl_VertexIndex].
-	//   PALETTE buffer — baked joint matrices (glm::mat4). Read as m[animBaseOffset + jointIndex].
+	//   PALETTE buffer — baked joint matrices as 3x4 affine rows (PaletteMatrix, 48 bytes).
+	//                    Read via shaders/palette.glsl as m[animBaseOffset + jointIndex].
 	//
 	// Both are registered once into the bindless descriptor set (bindings SKIN / PALETTE).
 	// A row's origin (baked at load vs. written live for IK/generative) is invisible to the GPU.
+	//
+	// Alongside the influences it can keep a copy of each skinned model's rest vertices (SKIN_REST,
+	// same base and allocator as the influences) for the optional compute pre-skinning pass. That
+	// 64 MB buffer exists only once pre-skinning was first switched on (enableRestVertices).
+	//
+	// It also owns the per-frame SKIN_INSTANCE buffers: one linear region per frame in flight that
+	// the animated passes fill with SkinInstance records each frame, so entities sharing a Model are
+	// drawn with one instanced draw instead of one draw (and push) per entity.
+	//
+	// Blocks are returned with the release* calls and their space reused, so spawning and
+	// despawning skinned entities no longer walks the cursor into the cap. The compact* calls close
+	// the gaps churn leaves behind; they move live data, so the GPU must be idle and the caller
+	// patches every stored base from the returned moves (Application::compactSkinBuffers).
 	class BGLSkinManager {
 	public:
+		// Returned by reservePalette when no free range is large enough.
+		static constexpr uint32_t INVALID_BASE = RangeAllocator::INVALID;
+
 		BGLSkinManager(BGLDevice& device, BGLBindlessDescriptorManager& descriptorManager);
 
-		// Append `vertexCount` influence entries (8 bytes each). Returns the base vertex index
-		// the model stores as ModelComponent::skinVertexBase.
+		// Write `vertexCount` influence entries (8 bytes each) into a fresh block. Returns the base
+		// vertex index the model stores as Model::skinVertexBase, or INVALID_BASE when the block does
+		// not fit even after compacting (see setCompactHandler) — the caller must check.
 		uint32_t uploadInfluences(const void* data, uint32_t vertexCount);
+		void     releaseInfluences(uint32_t base);
+		// Copy the model's rest vertices (BGLModel::Vertex, REST_VERTEX_STRIDE bytes each) next to its
+		// influences at `base` (the value uploadInfluences returned). Read by SkinningComputeSystem.
+		// A no-op until enableRestVertices.
+		void     uploadRestVertices(uint32_t base, const void* vertices, uint32_t vertexCount);
+		// Create and register the rest-vertex buffer (first use of compute pre-skinning). Models
+		// loaded before then have no rest copy yet: fill each with copyRestVertices.
+		void     enableRestVertices(BGLBindlessDescriptorManager& descriptorManager);
+		bool     hasRestVertices() const { return restBuffer != nullptr; }
+		// uploadRestVertices from a model's own vertex buffer (a blocking GPU copy).
+		void     copyRestVertices(VkBuffer vertexBuffer, uint32_t base, uint32_t vertexCount);
 
-		// Append `matrixCount` baked palette matrices. Returns the base matrix index the model's
-		// AnimationComponent stores as paletteBase.
-		uint32_t uploadPalette(const glm::mat4* data, uint32_t matrixCount);
+		static constexpr uint32_t REST_VERTEX_STRIDE = 64; // sizeof(BGLModel::Vertex)
 
-		// Bump-allocate `matrixCount` palette slots WITHOUT writing them, returning the base.
-		// Used for manual posing / IK: the caller overwrites the region later with writePalette.
+		// Write `matrixCount` baked palette matrices into a fresh block. Returns the base matrix index
+		// the model's shared SkinnedRig stores as paletteBase (once per Model, not per instance), or
+		// INVALID_BASE when the block does not fit even after compacting — the caller must check.
+		uint32_t uploadPalette(const PaletteMatrix* data, uint32_t matrixCount);
+
+		// Allocate `matrixCount` palette slots WITHOUT writing them, returning the base, or
+		// INVALID_BASE when the buffer has no free range that large. Used for manual posing / IK /
+		// runtime blends: the caller overwrites the region later with writePalette.
 		uint32_t reservePalette(uint32_t matrixCount);
+		// Free a block handed out by uploadPalette/reservePalette (its base as returned).
+		void     releasePalette(uint32_t base);
 
-		// Overwrite `count` matrices at an already-reserved `base` (does not advance the cursor).
+		// Overwrite `count` matrices at an already-allocated `base`.
 		// `base + count` must lie within a region previously handed out by reservePalette/uploadPalette.
-		void writePalette(uint32_t base, const glm::mat4* data, uint32_t count);
+		void writePalette(uint32_t base, const PaletteMatrix* data, uint32_t count);
+
+		// writePalette without the flush, for batches: safe to call from several threads at once as
+		// long as their regions are disjoint. Call flushPalette() once after the batch.
+		void stagePalette(uint32_t base, const PaletteMatrix* data, uint32_t count);
+		void flushPalette();
+
+		// Each pass that draws skinned instances owns a fixed slice of the frame's instance buffer,
+		// so a crowded cascade can never starve the g-buffer pass (or a later cascade).
+		static constexpr uint32_t GBUFFER_INSTANCE_PASS = 0;
+		static constexpr uint32_t shadowInstancePass(uint32_t cascadeIndex) { return 1 + cascadeIndex; }
+		static constexpr uint32_t INSTANCE_PASS_COUNT = 1 + SHADOW_CASCADE_COUNT;
+
+		// Start filling frame `frameIndex`'s instance buffer from the top. Call once per frame, after
+		// the frame's fence has been waited on (the GPU is done with the previous contents).
+		void beginInstanceFrame(uint32_t frameIndex);
+		// Append `count` instances to `pass`'s slice of this frame's buffer and flush. Returns the
+		// first instance index (use it as firstInstance), or INVALID_BASE when they do not all fit.
+		uint32_t pushInstances(uint32_t pass, const SkinInstance* data, uint32_t count);
+		uint32_t instancesLeft(uint32_t pass) const { return MAX_SKIN_INSTANCES - instanceCursor[pass]; }
+		static constexpr uint32_t instanceCapacity() { return MAX_SKIN_INSTANCES; } // per pass
+
+		// Slide the live blocks of a buffer down over its free gaps (GPU must be idle). Appends one
+		// move per block that changed place; every base equal to a move's `from` must be rewritten
+		// to its `to`.
+		void compactInfluences(std::vector<RangeAllocator::Move>& moves);
+		void compactPalette(std::vector<RangeAllocator::Move>& moves);
+
+		// Run when uploadInfluences/uploadPalette find no free range: it must compact both buffers AND
+		// patch every stored base (the application installs compactSkinBuffers), after which the
+		// upload retries once. Without a handler a full buffer fails straight away.
+		void setCompactHandler(std::function<void()> handler) { compactHandler = std::move(handler); }
+
+		// Placement policy for new blocks in both buffers.
+		void setFit(RangeAllocator::Fit fit) { skinAlloc.setFit(fit); paletteAlloc.setFit(fit); }
+
+		const RangeAllocator& influenceAllocator() const { return skinAlloc; }
+		const RangeAllocator& paletteAllocator()   const { return paletteAlloc; }
 
 		// Reset both allocators for a new scene (GPU must be idle; old contents get overwritten).
-		void clear() { skinCursor = 0; paletteCursor = 0; }
+		void clear() { skinAlloc.clear(); paletteAlloc.clear(); }
 
 	private:
 		static constexpr uint32_t INFLUENCE_STRIDE   = 8;          // bytes per vertex (must match SkinInfluence)
 		static constexpr uint32_t MAX_SKIN_VERTICES  = 1u << 20;   // 1,048,576 verts * 8B  = 8 MB
-		static constexpr uint32_t MAX_PALETTE_MATRICES = 200000;   // 200k mat4    * 64B = ~12.8 MB
+		// Same ~12.8 MB as the former 200k-mat4 palette; the 48-byte 3x4 rows fit a third more.
+		static constexpr uint32_t MAX_PALETTE_MATRICES = 266666;   // 266k 3x4     * 48B = ~12.8 MB
+		// Per pass, per frame in flight: 32k * 80B = 2.5 MB, times INSTANCE_PASS_COUNT (g-buffer plus
+		// each shadow cascade) = 12.5 MB a frame.
+		static constexpr uint32_t MAX_SKIN_INSTANCES = 1u << 15;
+
+		// Apply `moves` (ascending, each to < from) to a mapped buffer and flush it.
+		static void moveBlocks(BGLBuffer& buffer, uint32_t stride, const std::vector<RangeAllocator::Move>& moves, size_t first);
 
 		BGLDevice& device;
 		std::unique_ptr<BGLBuffer> skinBuffer;    // binding SKIN
+		std::unique_ptr<BGLBuffer> restBuffer;    // binding SKIN_REST, indexed like skinBuffer; null until enableRestVertices
 		std::unique_ptr<BGLBuffer> paletteBuffer; // binding PALETTE
-		uint32_t skinCursor    = 0;               // next free vertex slot
-		uint32_t paletteCursor = 0;               // next free matrix slot
+		RangeAllocator skinAlloc{ MAX_SKIN_VERTICES };        // vertex slots
+		RangeAllocator paletteAlloc{ MAX_PALETTE_MATRICES };  // matrix slots
+		std::function<void()> compactHandler;
+
+		std::array<std::unique_ptr<BGLBuffer>, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> instanceBuffers; // binding SKIN_INSTANCE
+		uint32_t instanceFrame = 0;
+		std::array<uint32_t, INSTANCE_PASS_COUNT> instanceCursor{}; // instances written per pass
+	};
+
+	// Per-pass scratch that groups the visible skinned entities by Model, uploads their instances
+	// contiguously per group and hands back one draw per Model. Owned by a render system and
+	// reused every pass, so steady-state frames do not allocate.
+	class SkinInstanceBatcher {
+	public:
+		struct Batch {
+			const Model* model;
+			uint32_t     firstInstance; // absolute index into this frame's instance buffer
+			uint32_t     instanceCount;
+		};
+
+		void clear() { pending.clear(); added.clear(); instances.clear(); batchList.clear(); }
+		void add(const Model* model, const SkinInstance& instance);
+
+		// Sort by Model, push the instances into `pass`'s slice and build the batch list. When the
+		// pass's budget runs short, the groups that fit are still uploaded (the last one possibly
+		// cut short) and the rest are left out. Returns the number of instances left out.
+		uint32_t upload(BGLSkinManager& skinManager, uint32_t pass);
+
+		const std::vector<Batch>& batches() const { return batchList; }
+
+	private:
+		struct Pending {
+			const Model* model;
+			uint32_t     index; // into `added`
+		};
+		std::vector<Pending>      pending;
+		std::vector<SkinInstance> added;
+		std::vector<SkinInstance> instances; // `added` reordered by Model
+		std::vector<Batch>        batchList;
 	};
 
 } // namespace bagel
@@ -11,6 +11,7 @@
 #endif
 
 // STL includes
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
@@ -28,6 +29,7 @@
 #include "bagel_camera.hpp"
 #include "bagel_frame_info.hpp"
 #include "bagel_hierachy.hpp"
+#include "bagel_worker_pool.hpp"
 #include "engine/bagel_engine_config.hpp"
 #include "imgui/bagel_imgui.hpp"
 #include "keyboard_movement_controller.hpp"
@@ -44,11 +46,12 @@ Application::Application()
     // BGLBindlessDescriptorManager::createBindlessDescriptorSet). Each set
     // consumes, on top of the GLOBAL_DESCRIPTOR_COUNT-sized bindless array of
     // each type:
-    //   storage buffers -- MATERIAL + SKIN + PALETTE, one single (non-array)
-    //   buffer each image samplers  -- the 4 deferred G-buffer targets + one per
-    //   shadow cascade
+    //   storage buffers -- MATERIAL + SKIN + PALETTE + SKIN_INSTANCE +
+    //   SKIN_REST + SKINNED_VERTEX, one single (non-array) buffer each
+    //   image samplers  -- the 4 deferred G-buffer targets + one per shadow
+    //   cascade
     constexpr uint32_t kFrames = BGLSwapChain::MAX_FRAMES_IN_FLIGHT;
-    constexpr uint32_t kSingleStorageBuffers = 3;
+    constexpr uint32_t kSingleStorageBuffers = 6;
     constexpr uint32_t kDeferredTargets = 4;
     constexpr uint32_t kShadowMaps =
         BGLBindlessDescriptorManager::SHADOW_MAP_CASCADE_COUNT;
@@ -87,6 +90,10 @@ Application::Application()
                                                            *descriptorManager);
     fallbackAlbedoMap = materialManager->loadTexture("/materials/grid.png");
     skinManager = std::make_unique<BGLSkinManager>(bglDevice, *descriptorManager);
+    // A model upload that does not fit compacts the skin buffers (patching every stored base) and retries.
+    skinManager->setCompactHandler([this] { CONSOLE->Log("Skin", compactSkinBuffers()); });
+    // Despawned (or scene-unloaded) skinned entities return their dynamic palette region.
+    registry.on_destroy<AnimationPlaybackComponent>().connect<&Application::releaseDynamicPalette>(this);
 }
 
 Application::~Application()
@@ -96,6 +103,7 @@ Application::~Application()
     // gone — and since those own no GPU resources, the buffers live only here.
     // run()'s final vkDeviceWaitIdle left the GPU idle, so it's safe to destroy
     // them.
+    registry.on_destroy<AnimationPlaybackComponent>().disconnect<&Application::releaseDynamicPalette>(this);
     ModelCacheManager::get().clear();
     ImGui_ImplVulkan_Shutdown();
     vkDestroyDescriptorPool(BGLDevice::device(), imguiPool, nullptr);
@@ -238,7 +246,7 @@ void Application::run()
 
     AnimatedGBufferRenderSystem animatedGBufferRenderSystem{
         bglRenderer.getDeferredRenderPass(), pipelineDescriptorSetLayouts,
-        descriptorManager, registry};
+        descriptorManager, *skinManager, registry};
 
     // Planets are drawn into the same deferred gbuffer as models, but by their own system so they
     // can later diverge to a dedicated terrain pipeline. It reuses the gbuffer_fill shaders, and
@@ -291,7 +299,16 @@ void Application::run()
 
     AnimatedShadowRenderSystem animatedShadowRenderSystem{
         bglRenderer.getShadowMapRenderPass(), pipelineDescriptorSetLayouts,
-        descriptorManager, registry};
+        descriptorManager, *skinManager, registry};
+
+    // Optional (computeSkinning): skins visible skinned entities once per frame for both the
+    // shadow cascades and the g-buffer, which then draw them with the static pipelines. Built the
+    // first time the toggle is switched on, so its pipeline and buffers cost nothing until then.
+    std::unique_ptr<SkinningComputeSystem> skinningComputeSystem;
+
+    // Per-instance frustum + cascade culling of the instanced batches, compacted into a
+    // per-frame buffer the shadow and g-buffer passes draw from.
+    InstanceCullSystem instanceCullSystem{bglDevice, descriptorManager, registry};
 
     ShadowRenderSystem shadowRenderSystem{bglRenderer.getShadowMapRenderPass(),
                                           pipelineDescriptorSetLayouts,
@@ -472,6 +489,7 @@ void Application::run()
 
         {
             t0 = Clock::now();
+            updateAnimationLOD(camera);        // decides which skeletons update this frame
             hierachy.ResolveSkeletonGlobals(); // resolve bones BEFORE parents so
                                                // attachments are current
             hierachy.ApplyHiarchialChange();
@@ -501,6 +519,9 @@ void Application::run()
             glm::inverse(cameraVP), exposure);
         pointLightSystem.update(ubo, 0);
         updateDirectionalUBO(registry, ubo, cameraWorldPos, camFwd, aspect);
+        animLodCascadeCount = ubo.hasDirLight ? SHADOW_CASCADE_COUNT : 0;
+        for (uint32_t ci = 0; ci < animLodCascadeCount; ci++)
+            animLodCascades[ci].extractFromVP(ubo.directionalLight.lightSpaceMatrix[ci]);
         recordSection(S_UBO, tMs(t0, Clock::now()));
 
         {
@@ -531,6 +552,20 @@ void Application::run()
 
         reregisterDescriptorEntries();
 
+        if (computeSkinning && !skinningComputeSystem)
+        {
+            // Models loaded so far were never given a rest-vertex copy; read it back from their
+            // vertex buffers.
+            skinManager->enableRestVertices(*descriptorManager);
+            ModelCacheManager::get().forEach([&](Model &model)
+            {
+                if (model.isSkinned)
+                    skinManager->copyRestVertices(model.vertexBuffer, model.skinVertexBase, model.vertexCount);
+            });
+            skinningComputeSystem = std::make_unique<SkinningComputeSystem>(
+                bglDevice, pipelineDescriptorSetLayouts, descriptorManager, registry);
+        }
+
         t0 = Clock::now();
         auto primaryCommandBuffer = bglRenderer.beginPrimaryCMD();
         recordSection(S_BEGINCMD, tMs(t0, Clock::now()));
@@ -552,6 +587,29 @@ void Application::run()
             int frameIdx = bglRenderer.getFrameIndex();
             uboBuffers->writeToIndex(&ubo, frameIdx);
             uboBuffers->flushIndex(frameIdx);
+            // This frame's fence has been waited on: its skinned instance buffer is free to refill.
+            skinManager->beginInstanceFrame(frameIdx);
+
+            // Compute pre-skinning runs before any render pass begins.
+            const PreSkinnedFrame *preSkinned = nullptr;
+            if (computeSkinning)
+            {
+                bglDevice.BeginDebugUtilsLabel(primaryCommandBuffer, "skinning");
+                skinningComputeSystem->dispatch(
+                    frameInfo, frameIdx,
+                    ubo.hasDirLight ? ubo.directionalLight.lightSpaceMatrix : nullptr,
+                    SHADOW_CASCADE_COUNT);
+                bglDevice.EndDebugUtilsLabel(primaryCommandBuffer);
+                preSkinned = &skinningComputeSystem->frame();
+            }
+
+            // This frame's fence has been waited on: its visible-instance buffer is free to refill.
+            instanceCullSystem.cull(frameInfo, frameIdx,
+                                    ubo.hasDirLight ? ubo.directionalLight.lightSpaceMatrix : nullptr,
+                                    SHADOW_CASCADE_COUNT);
+            const VisibleInstanceFrame &visibleInstances = instanceCullSystem.frame();
+            instancesCulledTotal = visibleInstances.instancesTotal;
+            instancesInCamera = visibleInstances.instancesInCamera;
 
             compositRenderSystem.pushParams.debugMode = (uint32_t)gbufferDebugMode;
             compositRenderSystem.pushParams.bloomHandle =
@@ -569,8 +627,12 @@ void Application::run()
                 {
                     bglRenderer.beginShadowMapPass(primaryCommandBuffer, ci);
                     shadowRenderSystem.renderShadowCasters(
-                        frameInfo, ci, ubo.directionalLight.lightSpaceMatrix[ci]);
-                    animatedShadowRenderSystem.renderShadowCasters(frameInfo, ci);
+                        frameInfo, ci, ubo.directionalLight.lightSpaceMatrix[ci], &visibleInstances);
+                    if (preSkinned)
+                        shadowRenderSystem.renderPreSkinned(frameInfo, ci, *preSkinned);
+                    animatedShadowRenderSystem.renderShadowCasters(
+                        frameInfo, ci, ubo.directionalLight.lightSpaceMatrix[ci],
+                        preSkinned);
                     bglRenderer.endCurrentRenderPass(primaryCommandBuffer);
                 }
                 bglDevice.EndDebugUtilsLabel(primaryCommandBuffer);
@@ -581,8 +643,10 @@ void Application::run()
             t0 = Clock::now();
             bglDevice.BeginDebugUtilsLabel(primaryCommandBuffer, "gbuffer_fill");
             bglRenderer.beginDeferredRenderPass(primaryCommandBuffer);
-            gBufferRenderSystem.renderEntities(frameInfo);
-            animatedGBufferRenderSystem.renderEntities(frameInfo);
+            gBufferRenderSystem.renderEntities(frameInfo, &visibleInstances);
+            if (preSkinned)
+                gBufferRenderSystem.renderPreSkinned(frameInfo, *preSkinned);
+            animatedGBufferRenderSystem.renderEntities(frameInfo, preSkinned);
             planetRenderSystem.renderEntities(frameInfo);
             bglRenderer.endCurrentRenderPass(primaryCommandBuffer);
             bglDevice.EndDebugUtilsLabel(primaryCommandBuffer);
@@ -756,10 +820,33 @@ void Application::syncFrameRate(
 }
 void Application::cacheTransforms()
 {
-    for (const auto &[_, tc] : registry.view<TransformComponent>().each())
-    {
-        tc.cacheMat4();
-    }
+    auto view = registry.view<TransformComponent>();
+    // Sized for the worst case (everything moved); only the dirty prefix is filled.
+    transformSoA.resize(view.size());
+    transformMats.resize(view.size());
+    transformOwners.resize(view.size());
+    size_t count = 0;
+    for (const auto &[_, tc] : view.each())
+        if (tc.isDirty())
+            transformOwners[count++] = &tc;
+    transformsRecached = static_cast<uint32_t>(count);
+
+    // Pack, compose and store back per chunk. Every index touches only its own SoA lane, matrix
+    // and component, so the result does not depend on how chunks land on threads. Up to one
+    // chunk of dirty transforms runs inline on this thread (parallelFor's single-chunk path).
+    constexpr uint32_t TRANSFORMS_PER_CHUNK = 2048; // multiple of 4: keeps chunks on SIMD lanes
+    WorkerPool::get().parallelFor(static_cast<uint32_t>(count), TRANSFORMS_PER_CHUNK,
+                                  [&](uint32_t begin, uint32_t end, uint32_t) {
+                                      for (uint32_t i = begin; i < end; ++i)
+                                      {
+                                          const TransformComponent &tc = *transformOwners[i];
+                                          transformSoA.set(i, tc.getWorldTranslation(), tc.getWorldRotation(),
+                                                           tc.getWorldScale());
+                                      }
+                                      composeTransforms(transformSoA, transformMats.data(), begin, end);
+                                      for (uint32_t i = begin; i < end; ++i)
+                                          transformOwners[i]->cacheMat4(transformMats[i]);
+                                  });
 }
 void Application::profile(double frameTime)
 {
@@ -784,7 +871,10 @@ void Application::profile(double frameTime)
             note = '*'; // queue submit + present
         printf("  %c %s : %7.3f ms  (%5.1f%%)\n", note, sectName[s], avg, pct);
     }
-    printf("  * = includes GPU sync point\n\n");
+    printf("  * = includes GPU sync point\n");
+    printf("  transforms re-cached last frame: %u\n", transformsRecached);
+    printf("  instanced: %u of %u culled instances in camera\n\n", instancesInCamera,
+           instancesCulledTotal);
     for (int s = 0; s < S_COUNT; s++)
     {
         perf[s].total = 0.0;
@@ -813,8 +903,71 @@ void Application::setTextureMipBias(float bias)
     if (materialManager)
         materialManager->getTextureLoader().setMipLodBias(bias);
 }
+void Application::updateAnimationLOD(const BGLCamera &camera)
+{
+    ++animLodFrame;
+    if (!animLodEnabled)
+    {
+        for (auto [e, anim] : registry.view<AnimationPlaybackComponent>().each())
+        {
+            anim.lodInterval = 1;
+            anim.lodVisible = true;
+            anim.lodDue = true;
+        }
+        return;
+    }
+
+    Frustum frustum;
+    frustum.extractFromVP(camera.getProjection() * camera.getView());
+    const glm::vec3 eye = glm::vec3(camera.getInverseView()[3]);
+    // projection[1][1] = 1 / tan(fovY/2): a sphere of radius r at distance d spans
+    // r * projY / d of the screen height (as a diameter / full-height fraction).
+    const float projY = camera.getProjection()[1][1];
+
+    for (auto [e, tc, mc, anim] :
+         registry.view<TransformComponent, ModelComponent, AnimationPlaybackComponent>().each())
+    {
+        const Model &model = mc.mesh();
+        // Bounds of the pose last drawn (the rest-pose AABB if none are known), grown by a margin
+        // so a limb swinging past them while updates are skipped doesn't get the character
+        // culled while still partly on screen.
+        glm::vec3 bMin = model.aabbMin, bMax = model.aabbMax;
+        anim.poseBounds(bMin, bMax);
+        const glm::vec3 center = 0.5f * (bMin + bMax);
+        const glm::vec3 half = 0.5f * (bMax - bMin) * cfg::kAnimLodBoundsMargin;
+        const glm::mat4 M = tc.computeMat4();
+        const bool wasVisible = anim.lodVisible;
+        anim.lodVisible = frustum.testAABB(center - half, center + half, M);
+        // Entities stagger by id so a crowd's reduced-rate updates spread evenly over the frames.
+        const uint32_t stagger = animLodFrame + static_cast<uint32_t>(entt::to_integral(e));
+        if (!anim.lodVisible)
+        {
+            // Off screen, but its shadow may still fall into view: keep a caster that reaches any
+            // cascade moving at the slowest rate. Anything else does no playback or skeleton work
+            // until it comes back.
+            bool casts = false;
+            for (uint32_t ci = 0; ci < animLodCascadeCount && !casts; ci++)
+                casts = animLodCascades[ci].testAABB(center - half, center + half, M);
+            anim.lodInterval = 8;
+            anim.lodDue = casts && stagger % anim.lodInterval == 0;
+            continue;
+        }
+
+        const glm::vec3 s = tc.getScale();
+        const float radius = glm::length(half) * std::max(std::abs(s.x), std::max(std::abs(s.y), std::abs(s.z)));
+        const float dist = glm::length(glm::vec3(M * glm::vec4(center, 1.0f)) - eye);
+        const float size = dist > radius ? radius * projY / dist : 1.0f;
+        anim.lodInterval = size >= animLodHalfRateSize      ? 1
+                           : size >= animLodQuarterRateSize ? 2
+                           : size >= animLodEighthRateSize  ? 4
+                                                            : 8;
+        // Coming back on screen updates at once; otherwise on its staggered frame.
+        anim.lodDue = !wasVisible || anim.lodInterval == 1 || stagger % anim.lodInterval == 0;
+    }
+}
 void Application::updateAnimation(float frameTime)
 {
+    manualPoseJobs.clear();
     for (auto [animEnt, anim] :
          registry.view<AnimationPlaybackComponent>().each())
     {
@@ -828,30 +981,209 @@ void Application::updateAnimation(float frameTime)
                     hasIK = true;
                     break;
                 }
-            if ((anim.poseDirty || hasIK) && anim.jointCount > 0)
+            // First manual pose of this entity: reserve its dynamic palette region now, so
+            // clip-only instances (crowds) never hold one.
+            if (anim.dynamicPaletteBase == AnimationPlaybackComponent::NO_DYNAMIC_PALETTE && anim.jointCount > 0)
+            {
+                anim.dynamicPaletteBase = reserveDynamicPalette(anim.jointCount);
+                if (anim.dynamicPaletteBase == AnimationPlaybackComponent::NO_DYNAMIC_PALETTE)
+                    continue; // palette buffer full even after compaction; keep showing the clip
+                anim.poseDirty = true;
+            }
+            // A new edit always re-resolves; the continuous IK re-solve follows the LOD rate.
+            if ((anim.poseDirty || (hasIK && anim.lodDue)) && anim.jointCount > 0)
             {
-                // editPose + IK -> final pose (same helper the gizmo uses to place
-                // markers).
-                Pose finalPose;
-                applyManualPose(rig.skeleton, rig.editPose, rig.ikSetups, finalPose);
-                // Reuse the persistent scratch buffer: after it has grown once,
-                // resize() to a size <= capacity does no allocation, so the per - frame
-                // path stays alloc-free.
-                paletteScratch.resize(anim.jointCount);
-                resolvePalette(rig.skeleton, finalPose, paletteScratch.data());
-                skinManager->writePalette(anim.dynamicPaletteBase,
-                                          paletteScratch.data(), anim.jointCount);
+                manualPoseJobs.push_back({&rig, &anim});
                 anim.poseDirty = false;
             }
             continue; // manual pose: skip clip playback for this entity
         }
+        if (anim.blended)
+            continue; // driven by its AnimationBlendComponent (updateAnimationBlends)
         if (!anim.playing)
+        {
+            anim.lodPendingTime = 0.0f;
+            continue;
+        }
+        if (!anim.lodDue)
+        {
+            anim.lodPendingTime += frameTime; // applied on the next due frame
             continue;
-        anim.time += frameTime;
+        }
+        anim.time += frameTime + anim.lodPendingTime;
+        anim.lodPendingTime = 0.0f;
         const float dur = anim.clipDuration();
         if (dur > 0.0f && anim.time > dur)
             anim.time = anim.loop ? std::fmod(anim.time, dur) : dur;
     }
+    solveManualPoses();
+    updateAnimationBlends(frameTime);
+}
+void Application::solveManualPoses()
+{
+    if (manualPoseJobs.empty())
+        return;
+    // Each job reads its own rig and writes only its own palette region and bounds, so the rigs
+    // split freely across the pool; the staged rows are flushed with a single call afterwards.
+    WorkerPool &pool = WorkerPool::get();
+    if (manualPoseScratch.size() < pool.threadCount())
+        manualPoseScratch.resize(pool.threadCount());
+    constexpr uint32_t POSES_PER_CHUNK = 2; // IK rigs are heavier per entity than a blend
+    pool.parallelFor(static_cast<uint32_t>(manualPoseJobs.size()), POSES_PER_CHUNK,
+                     [&](uint32_t begin, uint32_t end, uint32_t worker) {
+                         ManualPoseScratch &s = manualPoseScratch[worker];
+                         for (uint32_t i = begin; i < end; ++i)
+                         {
+                             const ManualPoseJob &job = manualPoseJobs[i];
+                             const AnimationComponent &rig = *job.anim;
+                             const uint32_t joints = job.play->jointCount;
+                             applyManualPose(rig.skeleton(), rig.editPose, rig.ikSetups, s);
+                             resolveGlobals(rig.skeleton(), s.pose, s.globals);
+                             s.palette.resize(joints);
+                             globalsToPalette(rig.skeleton(), s.globals, s.palette.data());
+                             skinManager->stagePalette(job.play->dynamicPaletteBase, s.palette.data(), joints);
+                             job.play->liveBounds = rig.rig ? skinnedBounds(rig.rig->jointBounds, s.palette.data()) : AnimBounds{};
+                         }
+                     });
+    skinManager->flushPalette();
+}
+// The "no region" marker doubles as the skin manager's allocation-failure value.
+static_assert(AnimationPlaybackComponent::NO_DYNAMIC_PALETTE == BGLSkinManager::INVALID_BASE);
+
+uint32_t Application::reserveDynamicPalette(uint32_t matrixCount)
+{
+    uint32_t base = skinManager->reservePalette(matrixCount);
+    if (base == BGLSkinManager::INVALID_BASE)
+    {
+        CONSOLE->Log("Skin", compactSkinBuffers());
+        base = skinManager->reservePalette(matrixCount);
+    }
+    return base;
+}
+void Application::releaseDynamicPalette(entt::registry &reg, entt::entity entity)
+{
+    const auto &play = reg.get<AnimationPlaybackComponent>(entity);
+    if (play.dynamicPaletteBase != AnimationPlaybackComponent::NO_DYNAMIC_PALETTE)
+        skinManager->releasePalette(play.dynamicPaletteBase);
+}
+std::string Application::compactSkinBuffers()
+{
+    // Compaction moves rows the in-flight frames may still be reading.
+    vkDeviceWaitIdle(BGLDevice::device());
+    std::vector<RangeAllocator::Move> skinMoves;
+    std::vector<RangeAllocator::Move> paletteMoves;
+    skinManager->compactInfluences(skinMoves);
+    skinManager->compactPalette(paletteMoves);
+
+    // Moves come out ascending by `from`, so each stored base is found by binary search. Only block
+    // bases are ever stored, so a base that is not some move's `from` stayed where it was.
+    auto relocate = [](const std::vector<RangeAllocator::Move> &moves, uint32_t &base)
+    {
+        auto it = std::lower_bound(moves.begin(), moves.end(), base,
+                                   [](const RangeAllocator::Move &m, uint32_t b) { return m.from < b; });
+        if (it != moves.end() && it->from == base)
+            base = it->to;
+    };
+    ModelCacheManager::get().forEach([&](Model &model)
+    {
+        if (!model.isSkinned)
+            return;
+        relocate(skinMoves, model.skinVertexBase);
+        if (model.rig)
+            relocate(paletteMoves, model.rig->paletteBase);
+    });
+    for (auto [ent, play] : registry.view<AnimationPlaybackComponent>().each())
+    {
+        relocate(paletteMoves, play.paletteBase);
+        if (play.dynamicPaletteBase != AnimationPlaybackComponent::NO_DYNAMIC_PALETTE)
+            relocate(paletteMoves, play.dynamicPaletteBase);
+    }
+
+    const RangeAllocator &pal = skinManager->paletteAllocator();
+    const RangeAllocator &infl = skinManager->influenceAllocator();
+    return "skin_compact: moved " + std::to_string(paletteMoves.size()) + " palette / " +
+           std::to_string(skinMoves.size()) + " influence blocks; palette " + std::to_string(pal.used()) + "/" +
+           std::to_string(pal.capacity()) + ", influences " + std::to_string(infl.used()) + "/" +
+           std::to_string(infl.capacity());
+}
+void Application::updateAnimationBlends(float frameTime)
+{
+    blendJobs.clear();
+    blendRetired.clear();
+    for (auto [ent, play, blend, anim] :
+         registry.view<AnimationPlaybackComponent, AnimationBlendComponent, AnimationComponent>().each())
+    {
+        if (play.manualPose || !anim.rig || play.jointCount == 0)
+            continue; // a manual pose owns the dynamic region while it is on
+        if (!play.lodDue)
+        {
+            play.lodPendingTime += frameTime; // applied on the next due frame
+            continue;
+        }
+        advanceBlend(blend, *anim.rig, frameTime + play.lodPendingTime);
+        play.lodPendingTime = 0.0f;
+        if (blend.layerCount == 0 || (blend.returnToBaked && blend.layerCount == 1 && blend.fadeDuration <= 0.0f))
+        {
+            // The fade has landed: continue the clip from the baked rows, in step with the blend.
+            if (blend.layerCount == 1)
+            {
+                const AnimationBlendComponent::Layer &l = blend.layers[0];
+                selectClip(play, anim, l.clip);
+                play.time = l.time;
+                play.loop = l.loop;
+                play.playing = true;
+            }
+            play.blended = false;
+            blendRetired.push_back(ent);
+            continue;
+        }
+        // Shares the manual-pose region: only one of the two writes it at a time.
+        if (play.dynamicPaletteBase == AnimationPlaybackComponent::NO_DYNAMIC_PALETTE)
+            play.dynamicPaletteBase = reserveDynamicPalette(play.jointCount);
+        if (play.dynamicPaletteBase == AnimationPlaybackComponent::NO_DYNAMIC_PALETTE)
+            continue; // palette buffer full even after compaction
+        play.blended = true;
+        blendJobs.push_back({&blend, anim.rig.get(), &play});
+    }
+
+    if (!blendJobs.empty())
+    {
+        // Each job reads its own rig and writes its own component cursors and palette region, so
+        // the entities split freely across the pool; the palette is flushed once afterwards.
+        WorkerPool &pool = WorkerPool::get();
+        if (blendScratch.size() < pool.threadCount())
+            blendScratch.resize(pool.threadCount());
+        constexpr uint32_t BLENDS_PER_CHUNK = 4;
+        pool.parallelFor(static_cast<uint32_t>(blendJobs.size()), BLENDS_PER_CHUNK,
+                         [&](uint32_t begin, uint32_t end, uint32_t worker) {
+                             BlendScratch &s = blendScratch[worker];
+                             BlendInput inputs[MAX_BLEND_INPUTS];
+                             for (uint32_t i = begin; i < end; ++i)
+                             {
+                                 const BlendJob &job = blendJobs[i];
+                                 const SkinnedRig &rig = *job.rig;
+                                 AnimationBlendComponent &blend = *job.blend;
+                                 for (uint32_t l = 0; l < blend.layerCount; ++l)
+                                 {
+                                     AnimationBlendComponent::Layer &layer = blend.layers[l];
+                                     inputs[l].clip = layer.clip < rig.clips.size() ? &rig.clips[layer.clip] : nullptr;
+                                     inputs[l].time = layer.time;
+                                     inputs[l].weight = layer.weight;
+                                     inputs[l].ctx = &layer.ctx;
+                                 }
+                                 evaluateBlend(rig.skeleton, inputs, blend.layerCount, s.pool, s.pose);
+                                 resolveGlobals(rig.skeleton, s.pose, s.globals);
+                                 s.palette.resize(rig.jointCount);
+                                 globalsToPalette(rig.skeleton, s.globals, s.palette.data());
+                                 skinManager->stagePalette(job.play->dynamicPaletteBase, s.palette.data(), rig.jointCount);
+                                 job.play->liveBounds = skinnedBounds(rig.jointBounds, s.palette.data());
+                             }
+                         });
+        skinManager->flushPalette();
+    }
+    // Removed only now: the jobs above hold pointers into the blend storage.
+    for (entt::entity e : blendRetired)
+        registry.remove<AnimationBlendComponent>(e);
 }
 void Application::registerDescriptorEntries()
 {
@@ -8,12 +8,14 @@
 #include "engine/bagel_window.hpp"
 #include "engine/renderer/bagel_renderer.hpp"
 
+#include "compute_systems/skinning_compute_system.hpp"
 #include "render_systems/animated_gbuffer_render_system.hpp"
 #include "render_systems/animated_shadow_render_system.hpp"
 #include "render_systems/bloom_render_system.hpp"
 #include "render_systems/composit_render_system.hpp"
 #include "render_systems/gbuffer_render_system.hpp"
 #include "render_systems/gizmo_render_system.hpp"
+#include "render_systems/instance_cull_system.hpp"
 #include "render_systems/planet_render_system.hpp"
 #include "render_systems/point_light_render_system.hpp"
 #include "render_systems/radiosity_render_system.hpp"
@@ -30,6 +32,7 @@
 #include "animation/bagel_skin_manager.hpp"
 #include "bagel_camera.hpp"
 #include "bagel_material.hpp"
+#include "math/bagel_transform_batch.hpp"
 
 #include <memory>
 #include <string>
@@ -41,6 +44,12 @@ namespace bagel
 {
 // Used by drawImgui() below by reference only; full definition is included in the .cpp.
 class KeyboardMovementController;
+// Referenced by pointer in the blend job list; defined in ecs/components/model.hpp.
+struct AnimationBlendComponent;
+struct AnimationPlaybackComponent;
+struct SkinnedRig;
+// cacheTransforms' write-back list; defined in ecs/components/transform.hpp.
+struct TransformComponent;
 // Per-section profiling accumulators (ms totals + sample counts)
 using Clock = std::chrono::high_resolution_clock;
 class Application
@@ -80,6 +89,10 @@ class Application
     entt::entity selectedEntity = entt::null;
     bool bloomEnabled = cfg::kBloomEnabled;
     bool smaaEnabled = true; // SMAA neighborhood blend (R_SMAA); off = passthrough
+    // Skin skinned entities once per frame in a compute pass (SkinningComputeSystem) instead of in
+    // the g-buffer and every shadow cascade's vertex shader. Settings panel toggle; the system and
+    // its buffers are created the first time it is switched on.
+    bool computeSkinning = false;
     float bloomIntensity = cfg::kBloomIntensity;
     float bloomThreshold = cfg::kBloomThreshold;
     float bloomMipDecay = cfg::kBloomMipDecay;
@@ -145,6 +158,13 @@ class Application
         return "[error] textmap: not supported in this app";
     }
 
+    // Close the gaps entity churn leaves in the skin-influence and palette SSBOs: waits for the GPU,
+    // compacts both buffers, then patches every stored base (cached Models' skinVertexBase and rig
+    // paletteBase, each playback component's paletteBase/dynamicPaletteBase). Console
+    // "skin_compact"; also run automatically when a dynamic palette reservation does not fit.
+    // Returns a status message.
+    std::string compactSkinBuffers();
+
     // Override in derived classes
     virtual void OnSceneLoad()
     {
@@ -231,12 +251,64 @@ class Application
     void initJolt();
     void initImgui();
 
+    // Animation LOD: classify every skinned entity by on-screen size and frustum visibility and set
+    // its AnimationPlaybackComponent::lodInterval/lodDue. Runs once the camera is final and before
+    // the skeleton resolve, which (like updateAnimation) only does work for due entities. Off-screen
+    // entities that still reach a shadow cascade keep updating at the slowest rate.
+    void updateAnimationLOD(const BGLCamera &camera);
+    bool animLodEnabled = cfg::kAnimLodEnabled;
+    float animLodHalfRateSize = cfg::kAnimLodHalfRateSize;
+    float animLodQuarterRateSize = cfg::kAnimLodQuarterRateSize;
+    float animLodEighthRateSize = cfg::kAnimLodEighthRateSize;
+    uint32_t animLodFrame = 0; // staggers the reduced-rate updates across entities
+    // Last frame's shadow cascade frusta (the cascades are fitted after the LOD pass runs; one frame
+    // of lag is covered by the bounds margin). Count 0: no directional light, no shadows.
+    Frustum animLodCascades[SHADOW_CASCADE_COUNT];
+    uint32_t animLodCascadeCount = 0;
+
     void updateAnimation(float frameTime);
-    // Reused scratch for updateAnimation's manual-pose palette resolve; resized in place each
-    // frame so the per-frame path doesn't heap-allocate after the first grow.
-    std::vector<glm::mat4> paletteScratch;
+    // Dynamic palette region for a manual pose or runtime blend; compacts and retries once when the
+    // palette buffer has no free range that large. NO_DYNAMIC_PALETTE if it still does not fit.
+    uint32_t reserveDynamicPalette(uint32_t matrixCount);
+    // registry.on_destroy<AnimationPlaybackComponent> hook: hand the entity's dynamic region back.
+    void releaseDynamicPalette(entt::registry &reg, entt::entity entity);
+    // Manual poses due this frame (new edit, or IK re-solve on an LOD-due frame). updateAnimation
+    // gathers them on the main thread, then solves editPose + IK -> palette across WorkerPool and
+    // flushes the palette once. Job list and per-worker scratch are reused between frames.
+    struct ManualPoseJob
+    {
+        const AnimationComponent *anim;
+        AnimationPlaybackComponent *play; // dynamicPaletteBase read late; liveBounds written
+    };
+    std::vector<ManualPoseJob> manualPoseJobs;
+    std::vector<ManualPoseScratch> manualPoseScratch; // one per pool thread
+    void solveManualPoses();
+    // Runtime blending (AnimationBlendComponent), run at the end of updateAnimation: advances every
+    // blend on the main thread, then evaluates the due ones across WorkerPool straight into their
+    // dynamic palette regions. The job list, per-worker scratch and retire list are reused, so a
+    // steady frame allocates nothing.
+    void updateAnimationBlends(float frameTime);
+    struct BlendJob
+    {
+        AnimationBlendComponent *blend;
+        const SkinnedRig *rig;
+        AnimationPlaybackComponent *play; // dynamicPaletteBase read late (a compaction may move it); liveBounds written
+    };
+    std::vector<BlendJob> blendJobs;
+    std::vector<BlendScratch> blendScratch; // one per pool thread
+    std::vector<entt::entity> blendRetired; // crossfades handed back to baked playback
     // Cache Mat4 transform of all entities. No updates to transformcomponents are allowed after this point.
+    // Packs the world values of every dirty TransformComponent into transformSoA, composes them four
+    // at a time (composeTransforms), and stores the results back, in chunks across WorkerPool.
+    // The staging vectors are reused.
     void cacheTransforms();
+    TransformSoA transformSoA;
+    std::vector<glm::mat4> transformMats;
+    std::vector<TransformComponent *> transformOwners;
+    uint32_t transformsRecached = 0; // last frame's dirty count, shown in the profiler output
+    // Last frame's instanced-batch culling (InstanceCullSystem), shown in the profiler output.
+    uint32_t instancesCulledTotal = 0;
+    uint32_t instancesInCamera = 0;
 
     void profile(double frameTime);
     // When a frame blows past stutterThresholdMs, print the slowest section that frame.
@@ -22,6 +22,7 @@ namespace bagel {
 		CONSOLE->AddCommandWithArg("EDITMODE", this, ConsoleCommand::SetEditMode);
 		CONSOLE->AddCommandWithArg("MAP", this, ConsoleCommand::LoadMap);
 		CONSOLE->AddCommandWithArg("TEXTMAP", this, ConsoleCommand::LoadTextMap);
+		CONSOLE->AddCommand("SKIN_COMPACT", this, ConsoleCommand::CompactSkinBuffers);
 		// Keybinds (Source-style): bind/unbind any console command to a key. No default binds —
 		// the grave/UI-toggle stays hard-coded in run() so it's always available. (TOGGLEUI is
 		// still registered so it can be bound to a *different* key if desired.)
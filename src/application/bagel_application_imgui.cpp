@@ -194,6 +194,34 @@ namespace bagel
 				ImGui::SliderFloat("Exposure", &exposure, 0.001f, 2.0f, "%.4f", ImGuiSliderFlags_Logarithmic);
 				resetBtn(exposure, cfg::kExposure);
 			}
+			ImGui::Text("Animation LOD");
+			ImGui::Checkbox("Animation LOD", &animLodEnabled);
+			resetBtn(animLodEnabled, cfg::kAnimLodEnabled);
+			if (animLodEnabled)
+			{
+				// Projected size (fraction of screen height) below which updates drop to 1/2, 1/4, 1/8 rate.
+				ImGui::SliderFloat("Half Rate Below", &animLodHalfRateSize, 0.001f, 1.0f, "%.3f", ImGuiSliderFlags_Logarithmic);
+				resetBtn(animLodHalfRateSize, cfg::kAnimLodHalfRateSize);
+				ImGui::SliderFloat("Quarter Rate Below", &animLodQuarterRateSize, 0.001f, 1.0f, "%.3f", ImGuiSliderFlags_Logarithmic);
+				resetBtn(animLodQuarterRateSize, cfg::kAnimLodQuarterRateSize);
+				ImGui::SliderFloat("Eighth Rate Below", &animLodEighthRateSize, 0.001f, 1.0f, "%.3f", ImGuiSliderFlags_Logarithmic);
+				resetBtn(animLodEighthRateSize, cfg::kAnimLodEighthRateSize);
+			}
+			// Skin once per frame in compute and draw with the static pipelines, instead of skinning in
+			// the g-buffer and every shadow cascade's vertex shader.
+			ImGui::Checkbox("Compute Skinning", &computeSkinning);
+			{
+				// Skin-influence / palette SSBO occupancy. Free space split across many ranges means a
+				// large rig may not fit although enough rows are free; Compact closes the gaps.
+				const RangeAllocator &pal = skinManager->paletteAllocator();
+				const RangeAllocator &infl = skinManager->influenceAllocator();
+				ImGui::Text("Palette %u / %u rows, %u blocks, largest free %u",
+							pal.used(), pal.capacity(), pal.blockCount(), pal.largestFree());
+				ImGui::Text("Influences %u / %u verts, %u blocks, largest free %u",
+							infl.used(), infl.capacity(), infl.blockCount(), infl.largestFree());
+				if (ImGui::Button("Compact Skin Buffers"))
+					CONSOLE->Log("Skin", compactSkinBuffers());
+			}
 			ImGui::Text("Water");
 			// Opaque at this water depth (world units) when viewed from the reference distance.
 			ImGui::SliderFloat("Water Opaque Depth", &waterOpaqueDepth, 0.1f, 64.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
@@ -149,6 +149,15 @@ namespace ConsoleCommand {
 		snprintf(response, sizeof(response), "%s", msg.c_str());
 		return response;
 	}
+	// skin_compact -- close the gaps entity churn left in the skin-influence / palette SSBOs.
+	const char* CompactSkinBuffers(void* ptr)
+	{
+		static char response[256];
+		Application* app = static_cast<Application*>(ptr);
+		const std::string msg = app->compactSkinBuffers();
+		snprintf(response, sizeof(response), "%s", msg.c_str());
+		return response;
+	}
 	// editmode <0|1>  ??toggle the bone-posing gizmo edit mode (same as the G hotkey).
 	const char* SetEditMode(void* ptr, const char* args)
 	{
@@ -1,10 +1,28 @@
 #include "bagel_hierachy.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring> // memset / memcpy for the attachment char[] copy
+#include <unordered_set>
+
+#include "bagel_worker_pool.hpp"
+#include "math/bagel_transform_batch.hpp"
 
 namespace bagel {
 
+// editPose + IK = the authored/posed bones (same final pose the palette bakes for manualPose),
+// resolved to model space into currentGlobals. `scratch` holds the intermediate pose.
+static void refreshSkeletonGlobals(AnimationComponent &anim, Pose &scratch) {
+  const SkeletonData &skel = anim.skeleton();
+  if (skel.empty()) // empty skeleton ⇔ no joints; jointCount lives on AnimationPlaybackComponent now
+    anim.currentGlobals.clear();
+  else {
+    applyManualPose(skel, anim.editPose, anim.ikSetups, scratch);
+    resolveGlobals(skel, scratch, anim.currentGlobals);
+  }
+  anim.globalsDirty = false;
+}
+
 // ---- attachment query API
 // ---------------------------------------------------------------
 
@@ -14,52 +32,120 @@ int lookupAttachment(entt::registry &registry, entt::entity entity,
   return ac ? ac->lookup(name) : -1;
 }
 
+// entityWorld * boneGlobal * localOffset for point `index` of `ac`, reading the
+// rig's current globals as they are (no refresh, so it is safe to call from the
+// parallel hierarchy pass).
+static bool attachmentWorld(const glm::mat4 &entityWorld,
+                            const AttachmentComponent &ac,
+                            const AnimationComponent *anim, int index,
+                            glm::mat4 &outWorld) {
+  if (index < 0 || index >= static_cast<int>(ac.points.size()))
+    return false;
+  const AttachmentComponent::Point &p = ac.points[index];
+  glm::mat4 boneGlobal{1.0f};
+  if (anim && p.joint >= 0 &&
+      p.joint < static_cast<int>(anim->currentGlobals.size()))
+    boneGlobal = anim->currentGlobals[p.joint];
+  outWorld = entityWorld * boneGlobal * p.localOffset;
+  return true;
+}
+
 bool getAttachmentWorld(entt::registry &registry, entt::entity entity,
                         int index, glm::mat4 &outWorld) {
   auto *ac = registry.try_get<AttachmentComponent>(entity);
-  if (!ac || index < 0 || index >= static_cast<int>(ac->points.size()))
-    return false;
   auto *tc = registry.try_get<TransformComponent>(entity);
-  if (!tc)
+  if (!ac || !tc)
     return false;
 
-  const AttachmentComponent::Point &p = ac->points[index];
-  glm::mat4 boneGlobal{1.0f};
-  if (auto *anim = registry.try_get<AnimationComponent>(entity))
-    if (p.joint >= 0 && p.joint < static_cast<int>(anim->currentGlobals.size()))
-      boneGlobal = anim->currentGlobals[p.joint];
+  auto *anim = registry.try_get<AnimationComponent>(entity);
+  // Rigs without attachment children are skipped by the resolve pass; bring them up to date
+  // here for ad-hoc callers.
+  if (anim && anim->globalsDirty) {
+    Pose pose;
+    refreshSkeletonGlobals(*anim, pose);
+  }
+  return attachmentWorld(tc->computeMat4(), *ac, anim, index, outWorld);
+}
 
-  outWorld = tc->computeMat4() * boneGlobal *
-             p.localOffset; // entityWorld * boneGlobal * localOffset
-  return true;
+// ---- HierarchyOrder maintenance
+// ----------------------------------------------------------
+
+static void onHierarchyConstruct(entt::registry &registry, entt::entity) {
+  HierarchyOrder &ho = registry.ctx().get<HierarchyOrder>();
+  if (!ho.creating)
+    ho.rebuild = true;
+}
+
+static void onHierarchyDestroy(entt::registry &registry, entt::entity) {
+  registry.ctx().get<HierarchyOrder>().stale = true;
+}
+
+// A (re)built attach point list: give it a generation no child has cached.
+static void onAttachmentChange(entt::registry &registry, entt::entity e) {
+  registry.get<AttachmentComponent>(e).generation =
+      ++registry.ctx().get<HierarchyOrder>().attachmentGeneration;
 }
 
-// Extract translation / per-axis scale / Euler XYZ from an affine matrix,
-// matching the X1Y2Z3 column layout TransformComponent::mat4() builds (so
-// feeding the Euler back through mat4() reproduces this rotation). Assumes no
-// shear (true for bone + uniform-ish transforms).
-static void decomposeToEuler(const glm::mat4 &m, glm::vec3 &t, glm::vec3 &euler,
-                             glm::vec3 &scale) {
-  t = glm::vec3(m[3]);
-  const glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
-  scale = {glm::length(c0), glm::length(c1), glm::length(c2)};
-  const glm::vec3 r0 = scale.x > 1e-8f ? c0 / scale.x : glm::vec3(1, 0, 0);
-  const glm::vec3 r1 = scale.y > 1e-8f ? c1 / scale.y : glm::vec3(0, 1, 0);
-  const glm::vec3 r2 = scale.z > 1e-8f ? c2 / scale.z : glm::vec3(0, 0, 1);
-  // glm column-major: r0=column0, etc. Convention element M[row][col] =
-  // column[col][row].
-  const float s2 = glm::clamp(r2.x, -1.0f, 1.0f); // M[0][2] = s2
-  euler.y = std::asin(s2);
-  euler.x = std::atan2(-r2.y, r2.z); // M[1][2]=-c2s1, M[2][2]=c1c2
-  euler.z = std::atan2(-r1.x, r0.x); // M[0][1]=-c2s3, M[0][0]=c2c3
+// The order lives in the registry context; the first system created on a
+// registry installs it and the signal hooks that keep it current.
+static HierarchyOrder &sharedOrder(entt::registry &registry) {
+  if (HierarchyOrder *ho = registry.ctx().find<HierarchyOrder>())
+    return *ho;
+  registry.on_construct<TransformHierachyComponent>()
+      .connect<&onHierarchyConstruct>();
+  registry.on_destroy<TransformHierachyComponent>()
+      .connect<&onHierarchyDestroy>();
+  registry.on_construct<AttachmentComponent>().connect<&onAttachmentChange>();
+  registry.on_update<AttachmentComponent>().connect<&onAttachmentChange>();
+  return registry.ctx().emplace<HierarchyOrder>();
 }
 
-HierachySystem::HierachySystem(entt::registry &_r) : registry{_r} {}
+HierachySystem::HierachySystem(entt::registry &_r)
+    : registry{_r}, order{sharedOrder(_r)} {}
+
+void HierachySystem::rebuildOrder() {
+  order.order.clear();
+  for (auto [e, hier] : registry.view<TransformHierachyComponent>().each())
+    if (hier.hasParent)
+      order.order.push_back(e);
+  // Stored depths are consistent with parents (they are maintained on every
+  // edit and serialized), so sorting by them yields a valid order.
+  auto hiers = registry.view<TransformHierachyComponent>();
+  std::stable_sort(order.order.begin(), order.order.end(),
+                   [&](entt::entity a, entt::entity b) {
+                     return hiers.get<TransformHierachyComponent>(a).depth <
+                            hiers.get<TransformHierachyComponent>(b).depth;
+                   });
+  order.rebuild = false;
+  pruneOrder(); // drops dangling parents and normalizes the depths
+}
+
+void HierachySystem::pruneOrder() {
+  auto hiers = registry.view<TransformHierachyComponent>();
+  // Parents come first, so each depth below is recomputed from an already
+  // updated parent; orphans (parent destroyed) become roots and leave the list.
+  size_t kept = 0;
+  for (entt::entity e : order.order) {
+    if (!hiers.contains(e))
+      continue;
+    auto &hier = hiers.get<TransformHierachyComponent>(e);
+    if (!registry.valid(hier.parent)) {
+      hier.hasParent = false;
+      hier.parent = entt::null;
+      hier.depth = 0;
+      continue;
+    }
+    const auto *ph = registry.try_get<TransformHierachyComponent>(hier.parent);
+    hier.depth = ph ? ph->depth + 1 : 1;
+    order.order[kept++] = e;
+  }
+  order.order.resize(kept);
+  order.stale = false;
+  order.levelsDirty = true;
+}
 
 void HierachySystem::CreateHierachy(entt::entity parent, entt::entity child,
                                     const std::string &attachment) {
-  TransformHierachyComponent *p =
-      registry.try_get<TransformHierachyComponent>(parent);
   if (registry.all_of<JoltPhysicsComponent>(child)) {
     // Dynamic bodies are owned by Jolt in world space; parenting would fight
     // the solver.
@@ -67,103 +153,243 @@ void HierachySystem::CreateHierachy(entt::entity parent, entt::entity child,
     // hierarchy child");
     return;
   }
+  // Settle pending destroys/loads first: the parent walk and the subtree move
+  // below rely on a consistent order with no dangling parents.
+  if (order.rebuild)
+    rebuildOrder();
+  else if (order.stale)
+    pruneOrder();
+  // Refuse cycles: `parent` must not be `child` or one of its descendants.
+  for (entt::entity a = parent;;) {
+    if (a == child)
+      return;
+    const auto *ah = registry.try_get<TransformHierachyComponent>(a);
+    if (ah && ah->hasParent)
+      a = ah->parent;
+    else
+      break;
+  }
+
+  order.creating = true;
+  TransformHierachyComponent *p =
+      registry.try_get<TransformHierachyComponent>(parent);
   if (p == nullptr) {
     p = &registry.emplace<bagel::TransformHierachyComponent>(parent);
   }
 
   TransformHierachyComponent *c =
       registry.try_get<TransformHierachyComponent>(child);
-  if (c == nullptr) {
+  const bool fresh = c == nullptr;
+  if (fresh) {
     c = &registry.emplace<bagel::TransformHierachyComponent>(child);
   }
+  order.creating = false;
+  // emplace may have grown the pool; re-fetch before writing through p.
+  p = &registry.get<TransformHierachyComponent>(parent);
 
   c->hasParent = true;
   c->parent = parent;
   c->depth = p->depth + 1;
+
+  // A child that just got its component is in neither the order nor anyone's
+  // parent chain: append it, which keeps building N children O(N).
+  if (fresh) {
+    order.order.push_back(child);
+    order.levelsDirty = true;
+  } else {
+    // Move the child and its descendants (if any, e.g. a subtree built
+    // bottom-up or a reparent) to the end, behind the new parent, keeping their
+    // relative order. The order is parent-first, so one pass finds the whole
+    // subtree.
+    auto hiers = registry.view<TransformHierachyComponent>();
+    std::unordered_set<entt::entity> subtree{child};
+    std::vector<entt::entity> moved;
+    size_t kept = 0;
+    for (entt::entity e : order.order) {
+      if (e == child)
+        continue;
+      auto &h = hiers.get<TransformHierachyComponent>(e);
+      if (subtree.count(h.parent)) {
+        subtree.insert(e);
+        moved.push_back(e);
+        continue;
+      }
+      order.order[kept++] = e;
+    }
+    order.order.resize(kept);
+    order.order.push_back(child);
+    for (entt::entity e : moved) {
+      auto &h = hiers.get<TransformHierachyComponent>(e);
+      h.depth = hiers.get<TransformHierachyComponent>(h.parent).depth + 1;
+      order.order.push_back(e);
+    }
+    order.levelsDirty = true;
+  }
+  c->localMatrixValid = false; // recompose against the new parent next pass
+  c->attachmentGeneration = 0; // re-resolve the attach point on the new parent
   if (attachment.length()) {
     c->hasAttachment = true;
-    // Clamp to the fixed buffer and keep it null-terminated: lookupAttachment()
-    // builds a std::string from this char[], which reads until the terminator.
+    // Clamp to the fixed buffer and keep it null-terminated: the attach point
+    // lookup compares it as a C string.
     size_t n = attachment.length();
     if (n > MAX_ATTACHMENT_NAME - 1)
       n = MAX_ATTACHMENT_NAME - 1;
     memset(c->attachment, 0, MAX_ATTACHMENT_NAME);
     memcpy(c->attachment, attachment.c_str(), n);
+  } else if (c->hasAttachment) {
+    // Reparented to a root transform: drop the previous parent's attach point.
+    c->hasAttachment = false;
+    memset(c->attachment, 0, MAX_ATTACHMENT_NAME);
   }
 }
 
 void HierachySystem::ResolveSkeletonGlobals() {
-  for (auto [e, anim] : registry.view<AnimationComponent>().each()) {
-    if (anim.skeleton.empty()) { // empty skeleton ⇔ no joints; jointCount lives on AnimationPlaybackComponent now
-      anim.currentGlobals.clear();
+  // Consumers: rigs some child is attached to. Recomputed every frame (a cheap scan over the
+  // hierarchy components) so reparenting, deletion and map loads need no bookkeeping.
+  auto anims = registry.view<AnimationComponent>();
+  for (auto [e, anim] : anims.each())
+    anim.hasAttachmentChildren = false;
+  for (auto [e, hier] : registry.view<TransformHierachyComponent>().each())
+    if (hier.hasParent && hier.hasAttachment && anims.contains(hier.parent))
+      anims.get<AnimationComponent>(hier.parent).hasAttachmentChildren = true;
+
+  for (auto [e, anim] : anims.each()) {
+    if (!anim.hasAttachmentChildren)
       continue;
-    }
-    // editPose + IK = the authored/posed bones (same final pose the palette
-    // bakes for manualPose). Resolved here so attachment points are current
-    // before parenting.
-    Pose pose;
-    applyManualPose(anim.skeleton, anim.editPose, anim.ikSetups, pose);
-    resolveGlobals(anim.skeleton, pose, anim.currentGlobals);
+    // A manual-pose edit this frame raises poseDirty on the playback side (cleared later by
+    // updateAnimation), which the globals must follow too.
+    const auto *play = registry.try_get<AnimationPlaybackComponent>(e);
+    if (play && play->manualPose && play->poseDirty)
+      anim.globalsDirty = true;
+    if (!anim.globalsDirty && anim.currentGlobals.size() == anim.skeleton().jointCount())
+      continue;
+    // Animation LOD: a rig that isn't due this frame stays dirty until it is (unless it has
+    // no globals at all yet).
+    if (play && !play->lodDue && !anim.currentGlobals.empty())
+      continue;
+    refreshSkeletonGlobals(anim, poseScratch);
   }
 }
 
+void HierachySystem::rebuildLevels() {
+  // Counting sort of the order by depth: one bucket per level, parents'
+  // level always before their children's.
+  auto hiers = registry.view<TransformHierachyComponent>();
+  order.levelBegin.assign(1, 0);
+  for (entt::entity e : order.order) {
+    const uint32_t d = hiers.get<TransformHierachyComponent>(e).depth;
+    if (order.levelBegin.size() < d + 2)
+      order.levelBegin.resize(d + 2, 0);
+    ++order.levelBegin[d + 1];
+  }
+  for (size_t l = 1; l < order.levelBegin.size(); ++l)
+    order.levelBegin[l] += order.levelBegin[l - 1];
+  order.levels.resize(order.order.size());
+  std::vector<uint32_t> cursor(order.levelBegin.begin(),
+                               order.levelBegin.end() - 1);
+  for (entt::entity e : order.order)
+    order.levels[cursor[hiers.get<TransformHierachyComponent>(e).depth]++] = e;
+  order.levelsDirty = false;
+}
+
 void HierachySystem::ApplyHiarchialChange() {
-  registry.sort<TransformHierachyComponent>(
-      [](const TransformHierachyComponent &lhs,
-         const TransformHierachyComponent &rhs) {
-        return lhs.depth < rhs.depth;
-      });
+  if (order.rebuild)
+    rebuildOrder();
+  else if (order.stale)
+    pruneOrder();
+  if (order.levelsDirty)
+    rebuildLevels();
+  if (order.levels.empty())
+    return;
 
-  auto view = registry.view<TransformHierachyComponent, TransformComponent>();
-  view.use<TransformHierachyComponent>();
+  auto hiers = registry.view<TransformHierachyComponent>();
+  auto transforms = registry.view<TransformComponent>();
 
-  for (auto [entity, hier, tc] : view.each()) {
-    if (!hier.hasParent)
+  // Roots of the first level: bring a moved root's cache up to date once, here,
+  // instead of once per child (which bumps its cache version for them).
+  // Every child of a root sits at depth 1.
+  for (uint32_t i = order.levelBegin[1]; i < order.levelBegin[2]; ++i) {
+    const entt::entity parent =
+        hiers.get<TransformHierachyComponent>(order.levels[i]).parent;
+    if (!transforms.contains(parent))
       continue;
+    auto &ptc = transforms.get<TransformComponent>(parent);
+    if (ptc.isDirty())
+      ptc.cacheMat4();
+  }
 
-    // Attachment parenting: ride a named attach point on the parent
-    // (bone-anchored) instead of the parent's root transform. Falls through to
-    // root parenting if the point is missing.
-    if (hier.hasAttachment) {
-      glm::mat4 aw;
-      const int ai = lookupAttachment(registry, hier.parent, hier.attachment);
-      if (ai >= 0 && getAttachmentWorld(registry, hier.parent, ai, aw)) {
-        glm::vec3 at, ar, as;
-        decomposeToEuler(aw, at, ar, as);
-        const float c3 = cosf(ar.z), s3 = sinf(ar.z);
-        const float c2 = cosf(ar.y), s2 = sinf(ar.y);
-        const float c1 = cosf(ar.x), s1 = sinf(ar.x);
-        const glm::mat3 attRot{
-            {c2 * c3, c1 * s3 + c3 * s1 * s2, s1 * s3 - c1 * c3 * s2},
-            {-c2 * s3, c1 * c3 - s1 * s2 * s3, c3 * s1 + c1 * s2 * s3},
-            {s2, -c2 * s1, c1 * c2}};
-        tc.setTranslation(at + attRot * (as * hier.localTranslation));
-        tc.setRotation(ar + hier.localRotation);
-        tc.setScale(as * hier.localScale);
-        continue;
-      }
-      // else: attachment unresolved this frame — fall back to root parenting
-      // below.
-    }
+  // Siblings never read each other, so each level is split across the pool;
+  // a level only reads the one above it, which is complete by then. Small
+  // levels run inline (single chunk).
+  constexpr uint32_t CHILDREN_PER_CHUNK = 512;
+  for (size_t level = 0; level + 1 < order.levelBegin.size(); ++level) {
+    const uint32_t begin = order.levelBegin[level];
+    const uint32_t count = order.levelBegin[level + 1] - begin;
+    if (count == 0)
+      continue;
+    WorkerPool::get().parallelFor(
+        count, CHILDREN_PER_CHUNK,
+        [&](uint32_t chunkBegin, uint32_t chunkEnd, uint32_t) {
+          for (uint32_t i = begin + chunkBegin; i < begin + chunkEnd; ++i)
+            propagate(order.levels[i]);
+        });
+  }
+}
+
+void HierachySystem::propagate(entt::entity entity) {
+  // Runs on pool threads. Only this child's own components are written; the
+  // parent side is read through the const registry, which never creates pools.
+  const entt::registry &reads = registry;
+  auto &hier = registry.get<TransformHierachyComponent>(entity);
+  auto *tc = registry.try_get<TransformComponent>(entity);
+  const auto *ptc = reads.try_get<TransformComponent>(hier.parent);
+  if (!tc || !ptc)
+    return;
+
+  // Recompose when the parent's cache was rewritten since this child last read
+  // it (by the level above, the root pre-pass, or cacheTransforms after a late
+  // move), and when the child's own transform was edited: a direct edit is
+  // overridden, as before.
+  bool recompose = hier.parentVersion != ptc->cacheVersion() || tc->isDirty();
+  if (!hier.localMatrixValid ||
+      hier.cachedLocalTranslation != hier.localTranslation ||
+      hier.cachedLocalRotation != hier.localRotation ||
+      hier.cachedLocalScale != hier.localScale) {
+    hier.localMatrix = composeTransform(hier.localTranslation,
+                                        hier.localRotation, hier.localScale);
+    hier.cachedLocalTranslation = hier.localTranslation;
+    hier.cachedLocalRotation = hier.localRotation;
+    hier.cachedLocalScale = hier.localScale;
+    hier.localMatrixValid = true;
+    recompose = true;
+  }
+  // The parent's cache is current: a hierarchy parent was composed one level
+  // up, a root by the first-level pre-pass (or untouched since last frame).
+  const glm::mat4 &parentWorld = ptc->getMat4();
 
-    auto &ptc = registry.get<TransformComponent>(hier.parent);
-
-    // Pure rotation matrix from parent's world rotation (XYZ Euler, no
-    // scale/translation)
-    const glm::vec3 pr = ptc.getRotation();
-    const float c3 = cosf(pr.z), s3 = sinf(pr.z);
-    const float c2 = cosf(pr.y), s2 = sinf(pr.y);
-    const float c1 = cosf(pr.x), s1 = sinf(pr.x);
-    const glm::mat3 parentRot{
-        {c2 * c3, c1 * s3 + c3 * s1 * s2, s1 * s3 - c1 * c3 * s2},
-        {-c2 * s3, c1 * c3 - s1 * s2 * s3, c3 * s1 + c1 * s2 * s3},
-        {s2, -c2 * s1, c1 * c2}};
-
-    const glm::vec3 ps = ptc.getScale();
-    tc.setTranslation(ptc.getTranslation() +
-                      parentRot * (ps * hier.localTranslation));
-    tc.setRotation(pr + hier.localRotation);
-    tc.setScale(ps * hier.localScale);
+  // Attachment parenting: ride a named attach point on the parent
+  // (bone-anchored) instead of the parent's root transform. Follows the bones
+  // every pass; falls through to root parenting if the point is missing. The
+  // name is matched only when the parent's attach points were rebuilt.
+  if (hier.hasAttachment) {
+    const auto *ac = reads.try_get<AttachmentComponent>(hier.parent);
+    if (ac && hier.attachmentGeneration != ac->generation) {
+      hier.attachmentIndex = ac->lookup(hier.attachment);
+      hier.attachmentGeneration = ac->generation;
+    }
+    glm::mat4 aw;
+    if (ac && attachmentWorld(parentWorld, *ac,
+                              reads.try_get<AnimationComponent>(hier.parent),
+                              hier.attachmentIndex, aw)) {
+      tc->setWorldMatrix(aw * hier.localMatrix);
+      hier.parentVersion = ptc->cacheVersion();
+      return;
+    }
   }
+
+  if (!recompose)
+    return;
+  tc->setWorldMatrix(parentWorld * hier.localMatrix);
+  hier.parentVersion = ptc->cacheVersion();
 }
 } // namespace bagel
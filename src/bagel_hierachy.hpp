@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 
 #include "entt.hpp"
 namespace bagel {
@@ -11,24 +12,61 @@ namespace bagel {
 	// Resolve a named attach point on `entity` (it must carry an AttachmentComponent). Mirrors
 	// Source's LookupAttachment / GetAttachment. The world transform is
 	//   entityWorld * boneGlobal * localOffset
-	// where boneGlobal comes from AnimationComponent::currentGlobals (resolved each frame BEFORE
-	// the hierarchy pass), or identity if the entity has no skeleton.
+	// where boneGlobal comes from AnimationComponent::currentGlobals (resolved BEFORE the hierarchy
+	// pass for rigs with attachment children, and on demand here for any other caller), or
+	// identity if the entity has no skeleton.
 	int  lookupAttachment(entt::registry& registry, entt::entity entity, const std::string& name);
 	bool getAttachmentWorld(entt::registry& registry, entt::entity entity, int index, glm::mat4& outWorld);
 
+	// Parent-before-child processing order of every hierarchy child (hasParent), shared through
+	// the registry context so every HierachySystem instance sees the same one. Kept up to date
+	// incrementally: CreateHierachy appends a new child, or moves a reparented subtree behind its
+	// new parent; destroying a hierarchy component only marks the order stale, and the next
+	// ApplyHiarchialChange drops dead entries and re-roots their orphans in one linear pass.
+	// Components constructed anywhere else (snapshot / map load) trigger a one-off rebuild.
+	struct HierarchyOrder {
+		std::vector<entt::entity> order;
+		bool rebuild  = true;  // re-derive from scratch (sorted by stored depth)
+		bool stale    = false; // some hierarchy component was destroyed since the last pass
+		bool creating = false; // inside CreateHierachy, which places its own entities
+		// `order` bucketed by depth: level d is levels[levelBegin[d], levelBegin[d + 1]).
+		// Re-derived (linear counting sort) only after the order changed.
+		std::vector<entt::entity> levels;
+		std::vector<uint32_t>     levelBegin;
+		bool     levelsDirty = true;
+		// Last AttachmentComponent::generation handed out; bumped whenever one is constructed,
+		// replaced or patched, so children re-resolve their attach point by name only then.
+		uint32_t attachmentGeneration = 1;
+	};
+
 	class HierachySystem {
 	public:
 		HierachySystem(entt::registry&);
 		~HierachySystem() = default;
 
 		// Parent `child` to `parent`. If `attachment` is non-empty, the child rides that named
-		// attach point on the parent (resolved each frame) instead of the parent's root transform.
+		// attach point on the parent instead of the parent's root transform. The name is resolved
+		// to a point index once and re-resolved only when the parent's AttachmentComponent is
+		// rebuilt; the bone it rides is followed every frame.
+		// Reparenting moves the child's whole subtree; parenting under its own descendant is refused.
 		void CreateHierachy(entt::entity parent, entt::entity child, const std::string& attachment = "");
-		// Resolve every skeleton's bone globals for this frame. MUST run before ApplyHiarchialChange
+		// Resolve the bone globals of every skeleton that has attachment-parented children and whose
+		// pose changed (AnimationComponent::globalsDirty). MUST run before ApplyHiarchialChange
 		// ("resolve bones before parents") so attachment-parented children read current bone poses.
 		void ResolveSkeletonGlobals();
+		// Compose every child's world matrix as parentWorld * local (attachment children: the
+		// attach point's world * local), one depth level at a time with each level split across
+		// WorkerPool. Children whose parent, local TRS and own transform are all unchanged skip;
+		// "unchanged parent" is judged by its cache version, not its dirty flag, so a parent moved
+		// after this pass is followed on the next one.
 		void ApplyHiarchialChange();
 	private:
 		entt::registry& registry;
+		HierarchyOrder& order;
+		void rebuildOrder();
+		void pruneOrder();
+		void rebuildLevels();
+		void propagate(entt::entity child);
+		Pose poseScratch; // editPose + IK, reused across rigs and frames
 	};
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "bagel_range_allocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bagel {
+
+	RangeAllocator::RangeAllocator(uint32_t capacity, Fit fit)
+		: cap{ capacity }, fit{ fit }
+	{
+		clear();
+	}
+
+	uint32_t RangeAllocator::allocate(uint32_t count)
+	{
+		if (count == 0) return INVALID;
+
+		auto pick = freeRanges.end();
+		for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+		{
+			if (it->second < count) continue;
+			if (fit == Fit::FIRST) { pick = it; break; }
+			if (pick == freeRanges.end() || it->second < pick->second) pick = it;
+			if (pick->second == count) break; // exact fit, nothing smaller can follow
+		}
+		if (pick == freeRanges.end()) return INVALID;
+
+		// Carve from the front of the range; the remainder stays free at the higher offset.
+		const uint32_t base = pick->first;
+		const uint32_t rest = pick->second - count;
+		freeRanges.erase(pick);
+		if (rest > 0) freeRanges.emplace(base + count, rest);
+		blocks.emplace(base, count);
+		usedCount += count;
+		return base;
+	}
+
+	void RangeAllocator::release(uint32_t base)
+	{
+		auto b = blocks.find(base);
+		if (b == blocks.end()) return;
+		uint32_t offset = b->first;
+		uint32_t count  = b->second;
+		usedCount -= count;
+		blocks.erase(b);
+
+		// Merge with the free range right after, then with the one right before.
+		auto next = freeRanges.lower_bound(offset);
+		if (next != freeRanges.end() && next->first == offset + count)
+		{
+			count += next->second;
+			next = freeRanges.erase(next);
+		}
+		if (next != freeRanges.begin())
+		{
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset)
+			{
+				prev->second += count;
+				return;
+			}
+		}
+		freeRanges.emplace(offset, count);
+	}
+
+	void RangeAllocator::clear()
+	{
+		blocks.clear();
+		freeRanges.clear();
+		if (cap > 0) freeRanges.emplace(0u, cap);
+		usedCount = 0;
+	}
+
+	void RangeAllocator::compact(std::vector<Move>& moves)
+	{
+		std::map<uint32_t, uint32_t> packed;
+		uint32_t cursor = 0;
+		for (const auto& [offset, count] : blocks)
+		{
+			if (offset != cursor) moves.push_back({ offset, cursor, count });
+			packed.emplace_hint(packed.end(), cursor, count);
+			cursor += count;
+		}
+		blocks.swap(packed);
+		freeRanges.clear();
+		if (cursor < cap) freeRanges.emplace(cursor, cap - cursor);
+	}
+
+	uint32_t RangeAllocator::largestFree() const
+	{
+		uint32_t largest = 0;
+		for (const auto& [offset, count] : freeRanges) largest = std::max(largest, count);
+		return largest;
+	}
+
+} // namespace bagel
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace bagel {
+
+	// Sub-allocator for index ranges [0, capacity) of a fixed-size GPU buffer (the skin-influence
+	// and palette SSBOs). Free space is kept as disjoint ranges sorted by offset; releasing a block
+	// merges it with free neighbours, so entity churn fragments the buffer no further than the live
+	// blocks force it to. compact() slides every live block down to close the gaps and reports the
+	// moves, so the owner can move the bytes and patch whoever stored the old bases.
+	//
+	// Bookkeeping only — it never touches the buffer — and not thread-safe.
+	class RangeAllocator {
+	public:
+		static constexpr uint32_t INVALID = UINT32_MAX;
+
+		enum class Fit : uint8_t {
+			FIRST, // lowest free range that fits: cheapest, keeps live data packed low
+			BEST,  // smallest free range that fits: keeps the large ranges whole for big blocks
+		};
+
+		// One relocated block: `count` indices moved from `from` to `to` (always to < from).
+		struct Move {
+			uint32_t from;
+			uint32_t to;
+			uint32_t count;
+		};
+
+		explicit RangeAllocator(uint32_t capacity, Fit fit = Fit::FIRST);
+
+		// Take `count` contiguous indices. Returns the base, or INVALID when no free range is large
+		// enough (compact() may make room) or count is 0.
+		uint32_t allocate(uint32_t count);
+
+		// Return the block that allocate() handed out at `base`. Unknown bases are ignored.
+		void release(uint32_t base);
+
+		// Drop every block (scene reset).
+		void clear();
+
+		// Move every live block down so the live data is contiguous from 0 and the free space is one
+		// range at the top. Appends one Move per block that changed place, in ascending order, so
+		// copying them front to back never overwrites a block before it has moved.
+		void compact(std::vector<Move>& moves);
+
+		void setFit(Fit f) { fit = f; }
+
+		uint32_t capacity()    const { return cap; }
+		uint32_t used()        const { return usedCount; }
+		uint32_t blockCount()  const { return static_cast<uint32_t>(blocks.size()); }
+		uint32_t largestFree() const;
+		// One past the highest live index: how much of the buffer a flush has to cover.
+		uint32_t highWater()   const { return blocks.empty() ? 0 : blocks.rbegin()->first + blocks.rbegin()->second; }
+
+	private:
+		std::map<uint32_t, uint32_t> freeRanges; // offset -> count
+		std::map<uint32_t, uint32_t> blocks;     // live: offset -> count
+		uint32_t cap       = 0;
+		uint32_t usedCount = 0;
+		Fit      fit       = Fit::FIRST;
+	};
+
+} // namespace bagel
@@ -0,0 +1,109 @@
+#include "bagel_worker_pool.hpp"
+
+namespace bagel {
+
+	// Set while a thread is executing chunks, so a nested parallelFor runs inline instead of
+	// deadlocking on dispatchMutex. workerIndex is that thread's `worker` id for the nested call.
+	static thread_local bool     tlsInsideJob = false;
+	static thread_local uint32_t tlsWorkerIndex = 0;
+
+	WorkerPool& WorkerPool::get()
+	{
+		static WorkerPool instance;
+		return instance;
+	}
+
+	WorkerPool::WorkerPool()
+	{
+		// Leave one hardware thread for the caller, which always works on its own jobs.
+		const unsigned hw = std::thread::hardware_concurrency();
+		const uint32_t count = hw > 1 ? hw - 1 : 0;
+		workers.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+			workers.emplace_back(&WorkerPool::workerLoop, this, i + 1); // worker 0 is the caller
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lk(mutex);
+			stop = true;
+		}
+		wakeCv.notify_all();
+		for (std::thread& t : workers) t.join();
+	}
+
+	void WorkerPool::runChunks(const Job& j, uint32_t worker)
+	{
+		const bool     wasInside = tlsInsideJob;
+		const uint32_t wasIndex  = tlsWorkerIndex;
+		tlsInsideJob   = true;
+		tlsWorkerIndex = worker;
+		for (uint32_t c = nextChunk.fetch_add(1, std::memory_order_relaxed); c < j.chunks;
+		     c = nextChunk.fetch_add(1, std::memory_order_relaxed))
+		{
+			const uint32_t begin = c * j.grain;
+			const uint32_t end   = (j.count - begin > j.grain) ? begin + j.grain : j.count;
+			j.call(j.ctx, begin, end, worker);
+		}
+		tlsInsideJob   = wasInside;
+		tlsWorkerIndex = wasIndex;
+	}
+
+	void WorkerPool::dispatch(uint32_t count, uint32_t grain, ChunkFn call, void* ctx)
+	{
+		if (count == 0) return;
+		if (grain == 0) grain = 1;
+		const uint32_t chunks = (count + grain - 1) / grain;
+		const uint32_t limit  = maxThreads.load(std::memory_order_relaxed);
+
+		// Inline: nothing to split, no workers, a serial cap, or we are already inside a job.
+		if (chunks == 1 || workers.empty() || limit == 1 || tlsInsideJob)
+		{
+			call(ctx, 0, count, tlsInsideJob ? tlsWorkerIndex : 0);
+			return;
+		}
+
+		std::lock_guard<std::mutex> serial(dispatchMutex);
+		Job j{ call, ctx, count, grain, chunks };
+		{
+			std::lock_guard<std::mutex> lk(mutex);
+			job = j;
+			nextChunk.store(0, std::memory_order_relaxed);
+			jobOpen = true;
+			++generation;
+		}
+		wakeCv.notify_all();
+
+		runChunks(j, 0);
+
+		// Every chunk has been claimed. Close the job so late wakers stay out, then wait for the
+		// workers still finishing a claimed chunk.
+		std::unique_lock<std::mutex> lk(mutex);
+		jobOpen = false;
+		doneCv.wait(lk, [&] { return joined == 0; });
+	}
+
+	void WorkerPool::workerLoop(uint32_t worker)
+	{
+		uint64_t seen = 0;
+		std::unique_lock<std::mutex> lk(mutex);
+		for (;;)
+		{
+			wakeCv.wait(lk, [&] { return stop || (jobOpen && generation != seen); });
+			if (stop) return;
+			seen = generation;
+
+			const uint32_t limit = maxThreads.load(std::memory_order_relaxed);
+			if (limit != 0 && worker >= limit) continue; // capped out of this job
+
+			const Job j = job;
+			++joined;
+			lk.unlock();
+			runChunks(j, worker);
+			lk.lock();
+			if (--joined == 0) doneCv.notify_all();
+		}
+	}
+
+} // namespace bagel
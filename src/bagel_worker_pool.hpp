@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bagel {
+
+	// Process-wide pool of CPU worker threads for data-parallel engine work (clip baking, and any
+	// other loop whose iterations write disjoint outputs). One job runs at a time: parallelFor
+	// splits [0, count) into `grain`-sized chunks, the workers AND the calling thread pull chunks
+	// from a shared counter, and the call returns once every chunk has run. There is no task graph
+	// and no futures — callers that need per-thread scratch index it by the `worker` argument,
+	// which is unique among the threads running one job and always < threadCount().
+	//
+	// Results are deterministic as long as each chunk writes only its own outputs: which thread
+	// runs a chunk changes, what the chunk computes does not. A parallelFor issued from inside a
+	// running job (or with a single chunk) simply runs inline on the calling thread.
+	class WorkerPool {
+	public:
+		// Meyers singleton; the workers start on first use and are joined at exit.
+		static WorkerPool& get();
+
+		// Threads that can take part in a job: the workers plus the calling thread.
+		uint32_t threadCount() const { return static_cast<uint32_t>(workers.size()) + 1; }
+
+		// Cap how many threads (caller included) join subsequent jobs; 0 or anything above
+		// threadCount() means all of them. Used to measure scaling and to force a serial run.
+		void setMaxThreads(uint32_t n) { maxThreads.store(n, std::memory_order_relaxed); }
+
+		// Run fn(begin, end, worker) over [0, count) in chunks of `grain` indices.
+		template<class Fn>
+		void parallelFor(uint32_t count, uint32_t grain, Fn&& fn)
+		{
+			using F = std::remove_reference_t<Fn>;
+			dispatch(count, grain,
+				[](void* ctx, uint32_t b, uint32_t e, uint32_t w) { (*static_cast<F*>(ctx))(b, e, w); },
+				const_cast<void*>(static_cast<const void*>(&fn)));
+		}
+
+		~WorkerPool();
+
+	private:
+		using ChunkFn = void (*)(void* ctx, uint32_t begin, uint32_t end, uint32_t worker);
+		struct Job {
+			ChunkFn  call  = nullptr;
+			void*    ctx   = nullptr;
+			uint32_t count = 0;
+			uint32_t grain = 1;
+			uint32_t chunks = 0;
+		};
+
+		WorkerPool();
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		void dispatch(uint32_t count, uint32_t grain, ChunkFn call, void* ctx);
+		void runChunks(const Job& job, uint32_t worker);
+		void workerLoop(uint32_t worker);
+
+		std::mutex              dispatchMutex; // one job at a time
+		std::mutex              mutex;         // guards job / generation / jobOpen / joined
+		std::condition_variable wakeCv;        // workers: a job was posted (or stop)
+		std::condition_variable doneCv;        // dispatcher: the last joined worker left
+		Job                     job;
+		uint64_t                generation = 0;
+		bool                    jobOpen    = false;
+		uint32_t                joined     = 0;
+		bool                    stop       = false;
+		std::atomic<uint32_t>   nextChunk{ 0 };
+		std::atomic<uint32_t>   maxThreads{ 0 };
+		// Last member: the threads start only after everything they touch is constructed.
+		std::vector<std::thread> workers;
+	};
+
+} // namespace bagel
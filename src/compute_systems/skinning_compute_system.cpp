@@ -0,0 +1,127 @@
+#include "compute_systems/skinning_compute_system.hpp"
+
+#include <algorithm>
+#include <iostream>
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include "math/bagel_math.hpp"
+#include "animation/bagel_skin_manager.hpp"
+#include "ecs/components/model.hpp"
+#include "ecs/components/transform.hpp"
+
+namespace bagel {
+
+	// Must match the push block in shaders/skin_vertices.comp.
+	struct SkinningComputePush {
+		uint32_t skinVertexBase = 0;
+		uint32_t dstVertexBase  = 0;
+		uint32_t vertexCount    = 0;
+		uint32_t animBaseOffset = 0;
+		uint32_t animNextOffset = 0;
+		float    animFrameBlend = 0.0f;
+	};
+
+	static constexpr uint32_t SKINNING_GROUP_SIZE = 64; // local_size_x in skin_vertices.comp
+
+	SkinningComputeSystem::SkinningComputeSystem(
+		BGLDevice& device,
+		std::vector<VkDescriptorSetLayout> setLayouts,
+		std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
+		entt::registry& _registry)
+		: BGLComputeSystem(setLayouts, sizeof(SkinningComputePush))
+		, registry{ _registry }
+	{
+		std::cout << "Creating Skinning Compute System\n";
+		createPipeline("/shaders/skin_vertices.comp.spv");
+
+		std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> infos;
+		for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			vertexBuffers[i] = std::make_unique<BGLBuffer>(
+				device,
+				BGLSkinManager::REST_VERTEX_STRIDE,
+				MAX_SKINNED_VERTICES,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			infos[i] = vertexBuffers[i]->descriptorInfo();
+		}
+		_descriptorManager->storeSkinnedVertexBuffers(infos);
+	}
+
+	void SkinningComputeSystem::dispatch(FrameInfo& frameInfo, uint32_t frameIndex, const glm::mat4* cascadeVPs, uint32_t cascadeCount)
+	{
+		clear();
+		current.vertexBuffer = vertexBuffers[frameIndex]->getBuffer();
+
+		Frustum cascades[SHADOW_CASCADE_COUNT];
+		cascadeCount = cascadeVPs ? std::min<uint32_t>(cascadeCount, SHADOW_CASCADE_COUNT) : 0;
+		for (uint32_t c = 0; c < cascadeCount; c++)
+			cascades[c].extractFromVP(cascadeVPs[c]);
+
+		bglPipeline->bind(frameInfo.commandBuffer);
+		vkCmdBindDescriptorSets(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			pipelineLayout,
+			0, 1,
+			&frameInfo.globalDescriptorSets,
+			0, nullptr);
+
+		uint32_t cursor = 0;
+		auto view = registry.view<TransformComponent, ModelComponent, AnimationPlaybackComponent>();
+		for (auto [entity, transform, model, anim] : view.each()) {
+			const Model& mesh = model.mesh();
+			if (!mesh.isSkinned || mesh.vertexCount == 0) continue;
+
+			// Same pose-bounds tests the animated passes would make, done once here for all of them.
+			PreSkinnedDraw draw{};
+			draw.modelMatrix = transform.getMat4();
+			glm::vec3 bMin, bMax;
+			const bool culls = model.frustumCull && anim.poseBounds(bMin, bMax);
+			draw.inCamera = !culls || frameInfo.cameraFrustum.testAABB(bMin, bMax, draw.modelMatrix);
+			for (uint32_t c = 0; c < cascadeCount; c++)
+				if (!culls || cascades[c].testAABB(bMin, bMax, draw.modelMatrix))
+					draw.cascadeMask |= static_cast<uint8_t>(1u << c);
+			if (!draw.inCamera && draw.cascadeMask == 0) continue;
+			if (mesh.vertexCount > MAX_SKINNED_VERTICES - cursor) continue; // left to the in-shader path
+
+			SkinningComputePush push{};
+			push.skinVertexBase = mesh.skinVertexBase;
+			push.dstVertexBase  = cursor;
+			push.vertexCount    = mesh.vertexCount;
+			push.animBaseOffset = anim.animBaseOffset();
+			push.animNextOffset = push.animBaseOffset + anim.jointCount;
+			push.animFrameBlend = anim.frameBlend();
+			vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
+				VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinningComputePush), &push);
+			bglPipeline->dispatch(frameInfo.commandBuffer,
+				(mesh.vertexCount + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, 1, 1);
+
+			draw.mesh            = &mesh;
+			draw.worldScale      = transform.getWorldScale();
+			draw.materialRowBase = mesh.skinBase + model.skinIndex * mesh.numSlots;
+			draw.vertexOffset    = static_cast<VkDeviceSize>(cursor) * BGLSkinManager::REST_VERTEX_STRIDE;
+			current.draws.push_back(draw);
+			current.handled.insert(entity);
+			cursor += mesh.vertexCount;
+		}
+		if (cursor == 0) return;
+
+		// The shadow and g-buffer passes fetch these vertices as vertex attributes.
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask       = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer              = current.vertexBuffer;
+		barrier.offset              = 0;
+		barrier.size                = static_cast<VkDeviceSize>(cursor) * BGLSkinManager::REST_VERTEX_STRIDE;
+		vkCmdPipelineBarrier(frameInfo.commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0, 0, nullptr, 1, &barrier, 0, nullptr);
+	}
+
+} // namespace bagel
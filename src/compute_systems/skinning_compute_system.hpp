@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "bagel_compute_system.hpp"
+#include "bagel_buffer.hpp"
+#include "bagel_frame_info.hpp"
+
+namespace bagel {
+
+	struct Model;
+
+	// One compute-skinned entity, drawn by the static passes out of PreSkinnedFrame::vertexBuffer.
+	struct PreSkinnedDraw {
+		const Model* mesh = nullptr;   // index buffer + submesh ranges
+		glm::mat4    modelMatrix{ 1.0f };
+		glm::vec3    worldScale{ 1.0f };
+		uint32_t     materialRowBase = 0;
+		VkDeviceSize vertexOffset    = 0; // byte offset of this entity's skinned vertices
+		bool         inCamera        = false;
+		uint8_t      cascadeMask     = 0; // bit c: reaches shadow cascade c
+	};
+
+	// What SkinningComputeSystem produced this frame. GBufferRenderSystem / ShadowRenderSystem draw
+	// the `draws`; the animated passes skip every entity in `handled` so nothing is drawn twice.
+	struct PreSkinnedFrame {
+		VkBuffer vertexBuffer = VK_NULL_HANDLE;
+		std::vector<PreSkinnedDraw> draws;
+		std::unordered_set<entt::entity> handled;
+
+		bool contains(entt::entity e) const { return handled.count(e) != 0; }
+	};
+
+	// Optional compute pre-skinning. The in-shader path skins every vertex once for the g-buffer and
+	// again in every shadow cascade it reaches (up to 5x per frame); this pass skins each skinned
+	// entity visible to the camera or any cascade ONCE into a per-frame vertex buffer in the static
+	// vertex format, and the static pipelines draw it from there. Each entity gets its own vertices,
+	// so these draws are per entity rather than instanced: it pays off with deep cascades and heavy
+	// meshes, while big crowds of light characters are better served by the instanced path.
+	// Entities past the per-frame vertex budget are left to the in-shader passes.
+	class SkinningComputeSystem : public BGLComputeSystem {
+	public:
+		SkinningComputeSystem(
+			BGLDevice& device,
+			std::vector<VkDescriptorSetLayout> setLayouts,
+			std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
+			entt::registry& _registry);
+
+		// Record this frame's dispatches and the compute -> vertex-input barrier. Must be called
+		// outside a render pass, before the shadow and g-buffer passes. `cascadeVPs` may be null
+		// (no directional light): only camera-visible entities are then skinned.
+		void dispatch(FrameInfo& frameInfo, uint32_t frameIndex, const glm::mat4* cascadeVPs, uint32_t cascadeCount);
+
+		// Forget the previous frame's output (pre-skinning switched off).
+		void clear() { current.draws.clear(); current.handled.clear(); }
+
+		const PreSkinnedFrame& frame() const { return current; }
+
+	private:
+		// Per frame in flight: 512k verts * 64B = 32 MB of device memory.
+		static constexpr uint32_t MAX_SKINNED_VERTICES = 1u << 19;
+
+		entt::registry& registry;
+		std::array<std::unique_ptr<BGLBuffer>, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> vertexBuffers; // binding SKINNED_VERTEX
+		PreSkinnedFrame current;
+	};
+
+} // namespace bagel
@@ -12,7 +12,7 @@
 // Persistent vs transient: each overload lists ONLY the authored/source-of-truth
 // fields. Runtime handles (VkBuffer, bindless handles, JPH::BodyID, mapped GPU
 // buffers) are never serialized — they are rebuilt afterwards in the rehydrate
-// pass from the persisted "recipe" (e.g. ModelComponent::loadSettings).
+// pass from the persisted "recipe" (e.g. ModelRecipeComponent::loadSettings).
 
 #include "ecs/bagel_ecs_components.hpp"
 
@@ -136,17 +136,23 @@ namespace bagel {
 		// All authored. (private members — this function is a friend.)
 		ar(c.translation, c.scale, c.rotation,
 		   c.localTranslation, c.localScale, c.localRotation);
+		// Transient: cached, dirty — written in place, so the matrix must be recomputed.
+		c.dirty = true;
 	}
 
 	template<class Archive>
 	void serialize(Archive& ar, TransformArrayComponent& c) {
-		// Persist only the used range [0, maxIndex); the arrays are fixed-capacity.
-		// Transient: usingBuffer, bufferHandle — rebuilt via ToBufferComponent().
-		ar(c.maxIndex);
-		for (std::uint32_t i = 0; i < c.maxIndex; ++i) {
-			ar(c.translation[i], c.scale[i], c.rotation[i],
-			   c.localTranslation[i], c.localScale[i], c.localRotation[i]);
+		// Instance count, then each instance's fields (same layout as when the lanes were
+		// fixed-capacity arrays). Loading sizes the lanes to the stored count.
+		// Transient: usingBuffer, bufferHandle, dirty range — rebuilt via ToBufferComponent().
+		std::uint32_t count = c.count();
+		ar(count);
+		if (count != c.count()) c.resize(count);
+		for (std::uint32_t i = 0; i < count; ++i) {
+			ar(c.lanes.translation[i], c.lanes.scale[i], c.lanes.rotation[i],
+			   c.lanes.localTranslation[i], c.lanes.localScale[i], c.lanes.localRotation[i]);
 		}
+		c.markAllDirty();
 	}
 
 	template<class Archive>
@@ -180,24 +186,26 @@ namespace bagel {
 		ar(s.albedo, s.normal, s.metalRough, s.emission);
 	}
 
-	// Shared model recipe: loadSettings + frustumCull + the generated-material sources.
-	// The loader rebuilds submeshes/GPU buffers from loadSettings during rehydrate. For
-	// OBJ/GLTF, materials come back from the asset (materialCount == 0); for GENERATED
-	// models the code-assigned material SOURCES are captured here and restored on rehydrate.
-	// materialSources[] is a fixed array, so length-prefix it with materialCount (submeshCount
-	// isn't serialized, so we can't derive the valid range any other way).
+	// The hot half of a model instance persists only its per-entity flags; `model` is transient
+	// and re-resolved from the entity's ModelRecipeComponent on rehydrate.
 	template<class Archive>
-	void serializeModelRecipe(Archive& ar, ModelComponent& c) {
+	void serialize(Archive& ar, ModelComponent& c) {
 		// skinIndex is the per-entity authored state; the skin block itself (skinBase/numSlots/
 		// numSkins) is transient and rebuilt from the .yaml sidecar by the loader on rehydrate.
-		ar(c.loadSettings, c.frustumCull, c.skinIndex, c.materialCount);
-		for (std::uint32_t i = 0; i < c.materialCount && i < ModelComponent::MAX_MATERIALS; ++i)
-			ar(c.materialSources[i]);
+		ar(c.frustumCull, c.skinIndex);
 	}
 
+	// Model recipe: loadSettings + the generated-material sources. The loader rebuilds
+	// submeshes/GPU buffers from loadSettings during rehydrate. For OBJ/GLTF, materials come
+	// back from the asset (materialCount == 0); for GENERATED models the code-assigned material
+	// SOURCES are captured here and restored on rehydrate. materialSources[] is a fixed array,
+	// so length-prefix it with materialCount (submeshCount isn't serialized, so we can't derive
+	// the valid range any other way).
 	template<class Archive>
-	void serialize(Archive& ar, ModelComponent& c) {
-		serializeModelRecipe(ar, c);
+	void serialize(Archive& ar, ModelRecipeComponent& c) {
+		ar(c.loadSettings, c.materialCount);
+		for (std::uint32_t i = 0; i < c.materialCount && i < ModelRecipeComponent::MAX_MATERIALS; ++i)
+			ar(c.materialSources[i]);
 	}
 
 	// WireframeComponent is standalone (no longer a ModelComponent), so it carries only its
@@ -317,6 +325,7 @@ namespace bagel {
 		saveComponent<PointLightComponent>(snap, ar, registry);
 		saveComponent<DirectionalLightComponent>(snap, ar, registry);
 		saveComponent<ModelComponent>(snap, ar, registry);
+		saveComponent<ModelRecipeComponent>(snap, ar, registry);
 		saveComponent<WireframeComponent>(snap, ar, registry);
 		saveComponent<AnimationComponent>(snap, ar, registry);
 		saveComponent<AnimationPlaybackComponent>(snap, ar, registry);
@@ -336,6 +345,7 @@ namespace bagel {
 			.get<PointLightComponent>(ar)
 			.get<DirectionalLightComponent>(ar)
 			.get<ModelComponent>(ar)
+			.get<ModelRecipeComponent>(ar)
 			.get<WireframeComponent>(ar)
 			.get<AnimationComponent>(ar)
 			.get<AnimationPlaybackComponent>(ar)
@@ -1,20 +1,41 @@
 #include "ecs/components/data_buffer.hpp"
 namespace bagel {
-    DataBufferComponent::DataBufferComponent(BGLDevice& device, BGLBindlessDescriptorManager& descriptorManager, uint32_t bufferUnitsize, const char* bufferName = NULL)
+    DataBufferComponent::DataBufferComponent(BGLDevice& device, BGLBindlessDescriptorManager& descriptorManager, uint32_t bufferUnitsize, const char* bufferName, uint32_t initialUnits)
+        : device(&device), descriptorManager(&descriptorManager), unitSize(bufferUnitsize)
+    {
+        allocate(initialUnits > 0 ? initialUnits : 1);
+        bufferHandle = descriptorManager.storeBuffer(objDataBuffer->descriptorInfo(), bufferName);
+    }
+
+    void DataBufferComponent::allocate(uint32_t units)
     {
         objDataBuffer = std::make_unique<BGLBuffer>(
-            device,
-            bufferUnitsize,
-            MAX_TRANSFORM_PER_ENT,
+            *device,
+            unitSize,
+            units,
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
         objDataBuffer->map();
-        bufferHandle = descriptorManager.storeBuffer(objDataBuffer->descriptorInfo(), bufferName);
     }
-    
+
+    bool DataBufferComponent::reserve(uint32_t units)
+    {
+        const uint32_t current = capacity();
+        if (units <= current) return false;
+        const uint32_t grown = units > current * 2 ? units : current * 2;
+        vkDeviceWaitIdle(BGLDevice::device());
+        allocate(grown);
+        descriptorManager->rebindBuffer(static_cast<uint16_t>(bufferHandle), objDataBuffer->descriptorInfo());
+        return true;
+    }
+
     void DataBufferComponent::writeToBuffer(void* data, size_t size, size_t offset)
     {
         objDataBuffer->writeToBuffer(data, size, offset);
+    }
+
+    void DataBufferComponent::flush()
+    {
         objDataBuffer->flush();
     }
 }
\ No newline at end of file
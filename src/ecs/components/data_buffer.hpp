@@ -7,13 +7,15 @@
 #include "bagel_buffer.hpp"
 #include "engine/bagel_engine_device.hpp"
 #include "engine/bagel_descriptors.hpp"
+#include "engine/bagel_engine_config.hpp"
 
 namespace bagel {
 	struct DataBufferComponent {
 		std::unique_ptr<BGLBuffer> objDataBuffer;
 		uint32_t bufferHandle;
 
-		DataBufferComponent(BGLDevice& device, BGLBindlessDescriptorManager& descriptorManager, uint32_t bufferUnitsize, const char* bufferName);
+		// Room for `initialUnits` units of `bufferUnitsize` bytes; reserve() grows it.
+		DataBufferComponent(BGLDevice& device, BGLBindlessDescriptorManager& descriptorManager, uint32_t bufferUnitsize, const char* bufferName, uint32_t initialUnits = DATA_BUFFER_INITIAL_UNITS);
 		// Move-only: owns a GPU buffer via the unique_ptr. Copying would double-free it;
 		// entt relocates by moving. No custom destructor — BGLBuffer's destructor unmaps
 		// and frees. (The old destructor only redundantly unmapped and would null-deref a
@@ -22,7 +24,23 @@ namespace bagel {
 		DataBufferComponent& operator=(const DataBufferComponent&) = delete;
 		DataBufferComponent(DataBufferComponent&&) noexcept = default;
 		DataBufferComponent& operator=(DataBufferComponent&&) noexcept = default;
+		// Copies into the mapped buffer; call flush() once after a batch of writes.
 		void writeToBuffer(void* data, size_t size, size_t offset);
+		void flush();
+		// Make room for `units` units. When the buffer has to grow it is reallocated (at least
+		// doubling) with its contents DISCARDED, and the same bindless handle is re-pointed at
+		// it, so push constants holding bufferHandle stay valid. Returns true if that happened
+		// and the caller must rewrite everything. Waits for the device first: in-flight frames
+		// may still read the old buffer. Growth is a load/spawn-time event, not per frame.
+		bool reserve(uint32_t units);
+		uint32_t capacity() const { return objDataBuffer->getInstanceCount(); }
 		uint32_t getBufferHandle() const { return bufferHandle; }
+
+	private:
+		void allocate(uint32_t units);
+
+		BGLDevice* device;
+		BGLBindlessDescriptorManager* descriptorManager;
+		uint32_t unitSize;
 	};
 }
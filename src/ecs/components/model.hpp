@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,8 +26,13 @@ namespace bagel
 // ModelCacheManager) plus this entity's per-instance state. Holds NO GPU
 // resources, so destroying the entity frees nothing GPU-side and can never
 // dangle another instance's buffers — the fix for the old owner/borrower
-// double-free. `model` is resolved from the cache at build/load;
-// loadSettings.source is the serialized identity used to re-resolve it.
+// double-free. `model` is resolved from the cache at build/load; the
+// entity's ModelRecipeComponent carries the serialized identity used to
+// re-resolve it.
+//
+// HOT: every render pass iterates this pool each frame, so it holds only what
+// a draw reads — pointer, skin row and flags, 16 bytes. The build recipe
+// (strings) lives in the cold ModelRecipeComponent below.
 struct ModelComponent
 {
     // Compat aliases so existing `ModelComponent::Submesh` / `::MAX_SUBMESHES`
@@ -38,17 +47,6 @@ struct ModelComponent
     // (or on map rehydrate).
     Model *model = nullptr;
 
-    // The build recipe — serialized identity of this instance's model.
-    // loadSettings.source is the cache key used to (re)resolve `model` on load.
-    ModelLoadSettings loadSettings{};
-
-    // Material recipe for GENERATED models (source paths, indexed by
-    // Submesh::materialIndex), kept per-entity so a generated model's authored
-    // materials survive save/load. Empty for OBJ/GLTF/LDraw, whose materials come
-    // back from the asset. materialCount = valid slots.
-    bagel::MaterialSource materialSources[MAX_MATERIALS]{};
-    uint32_t materialCount = 0;
-
     // This entity's selected skin row (per-instance) and frustum-cull toggle.
     uint8_t skinIndex = 0;
     bool frustumCull = true;
@@ -73,18 +71,6 @@ struct ModelComponent
             skinIndex = static_cast<uint8_t>(i);
     }
 
-    // Record a generated model's material source for slot `materialIdx` (= a
-    // submesh's materialIndex). Serialized; the loader re-bakes textures from
-    // these paths on rehydrate.
-    void setMaterialSource(uint32_t materialIdx,
-                           const bagel::MaterialSource &src)
-    {
-        assert(materialIdx < MAX_MATERIALS);
-        materialSources[materialIdx] = src;
-        if (materialIdx + 1 > materialCount)
-            materialCount = materialIdx + 1;
-    }
-
     // Submesh ranges + transparency test — forwarded from the shared model.
     SubmeshRange solidSubmeshes() const
     {
@@ -100,6 +86,39 @@ struct ModelComponent
     }
 };
 
+// COLD half of a built model: the recipe it was cooked from. Emplaced beside
+// ModelComponent by ModelComponentBuilder::buildComponent, read only when
+// saving a map, rehydrating one, or inspecting the entity — never by the
+// render passes. Generated meshes built straight from vertex data (planets)
+// carry none; their identity is the shared Model's own loadSettings.
+struct ModelRecipeComponent
+{
+    static constexpr uint32_t MAX_MATERIALS = Model::MAX_MATERIALS;
+
+    // Serialized identity of this instance's model. loadSettings.source is
+    // the cache key used to (re)resolve ModelComponent::model on load.
+    ModelLoadSettings loadSettings{};
+
+    // Material recipe for GENERATED models (source paths, indexed by
+    // Submesh::materialIndex), kept per-entity so a generated model's authored
+    // materials survive save/load. Empty for OBJ/GLTF/LDraw, whose materials come
+    // back from the asset. materialCount = valid slots.
+    bagel::MaterialSource materialSources[MAX_MATERIALS]{};
+    uint32_t materialCount = 0;
+
+    // Record a generated model's material source for slot `materialIdx` (= a
+    // submesh's materialIndex). Serialized; the loader re-bakes textures from
+    // these paths on rehydrate.
+    void setMaterialSource(uint32_t materialIdx,
+                           const bagel::MaterialSource &src)
+    {
+        assert(materialIdx < MAX_MATERIALS);
+        materialSources[materialIdx] = src;
+        if (materialIdx + 1 > materialCount)
+            materialCount = materialIdx + 1;
+    }
+};
+
 struct WireframeComponent
 {
     static constexpr uint32_t MAX_SUBMESHES = 128;
@@ -136,74 +155,169 @@ struct WireframeComponent
     glm::vec4 color = {1.0f, 1.0f, 1.0f, 1.0f};
 };
 
-// Rig + baked identity for a skinned entity (paired with the hot AnimationPlaybackComponent).
+// Named bone attach points baked from the model's "<model>.yaml" sidecar — the
+// Source-engine $attachment analog. Each point is a local offset (translation +
+// rotation) within a skeleton bone's space; its world transform is bone_world *
+// localOffset. Transient: the model builder rebuilds it from the sidecar on
+// load/rehydrate (not serialized — the sidecar owns it). Query via
+// lookupAttachment() / getAttachmentWorld() in bagel_hierachy.hpp. A
+// TransformHierachyComponent can name one of these to parent a child to the
+// point.
+struct AttachmentComponent
+{
+    struct Point
+    {
+        char name[MAX_ATTACHMENT_NAME] =
+            {};                      // referenced by
+                                     // TransformHierachyComponent::attachment
+                                     // / code; zero-init = valid empty
+                                     // C-string before it's filled
+        int joint = -1;              // skeleton joint the point rides (resolved from bone name)
+        glm::mat4 localOffset{1.0f}; // offset within the bone's local space
+    };
+    std::vector<Point> points;
+    // Transient: a fresh value each time the component is constructed (rebuilt from the sidecar)
+    // or replaced/patched, assigned by the hierarchy's registry hooks. Hierarchy children cache
+    // the index of their attach point against it (TransformHierachyComponent::attachmentIndex).
+    uint32_t generation = 1;
+
+    // Attachment name -> index into points (or -1). Mirrors Source's
+    // LookupAttachment.
+    int lookup(const char *name) const
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+            if (std::strncmp(points[i].name, name, MAX_ATTACHMENT_NAME) == 0)
+                return static_cast<int>(i);
+        return -1;
+    }
+    int lookup(const std::string &name) const { return lookup(name.c_str()); }
+};
+// Immutable rig data shared by every instance of one skinned Model: the skeleton, the baked
+// palette rows (uploaded ONCE into the resident palette SSBO at paletteBase) and their per-clip
+// frame tables, plus the sidecar's default IK chains and attach points. Built by the model
+// builder on the Model's first build and held by Model::rig; instances reference it through
+// AnimationComponent::rig, so N copies of a character cost one bake and one palette block.
+struct SkinnedRig
+{
+    SkeletonData skeleton{};                 // restPose / parents / inverseBind / order / names
+    std::vector<uint32_t> clipFrameBases{};  // per clip: first frame row (in frames)
+    std::vector<uint32_t> clipFrameCounts{}; // per clip: baked frame count
+    std::vector<std::string> clipNames{};    // per clip: glTF animation name
+    // The (reduced) source curves, same clip order: sampled live by AnimationBlendComponent layers.
+    std::vector<AnimationClip> clips{};
+    float fps = 60.0f;                       // frames/sec the clips were baked at
+    uint32_t jointCount = 0;
+    // Matrix index of (clip 0, frame 0) in the palette SSBO. A clip-less rig uploads a single
+    // rest-pose frame here instead.
+    uint32_t paletteBase = 0;
+    // Culling bounds. jointBounds[j]: bind-space box of the vertices joint j moves (skinnedBounds
+    // input for live poses). frameBounds: model-space box of each baked frame row, indexed like the
+    // rows (clipFrameBases[c] + frame), or the rest pose for a clip-less rig.
+    std::vector<AnimBounds> jointBounds{};
+    std::vector<AnimBounds> frameBounds{};
+    std::vector<IKSetup> ikSetups{};                   // sidecar defaults, copied per instance
+    std::vector<AttachmentComponent::Point> attachments{}; // sidecar attach points
+};
+
+// Rig + authored pose for a skinned entity (paired with the hot AnimationPlaybackComponent).
 // "Cold" only relative to the loops the split targets: it is deliberately kept OUT of
 // updateAnimation and the animated render passes, which instead stream the small scalar-only
 // playback component. It IS still read every frame by the skeleton-resolve pass
 // (ResolveSkeletonGlobals, for attachment parenting) — but that pass fundamentally needs the
 // skeleton, so no split makes it lean. Otherwise touched only on load/build and pose editing.
+// The skeleton and clip tables are NOT copied per entity: they live in the shared SkinnedRig.
 // Built in attachSkinningState.
 struct AnimationComponent
 {
-    // Per-clip baked frame tables (parallel arrays, indexed by clip). The CURRENT clip's window is
-    // cached as scalars in AnimationPlaybackComponent for the hot path; these full tables are read
-    // only when the clip changes (to refresh that cache) and by the debug UI.
-    std::vector<uint32_t> clipFrameBases{};  // per clip: first frame row (in frames)
-    std::vector<uint32_t> clipFrameCounts{}; // per clip: baked frame count
-    std::vector<std::string>
-        clipNames{}; // per clip: glTF animation name (parallel to clipFrameBases)
+    // Shared, read-only rig of this entity's Model. Null only on a component restored from a map
+    // snapshot before the builder re-attaches it (see bagel_map_io.cpp).
+    std::shared_ptr<const SkinnedRig> rig{};
     // Model-space joint matrices for THIS frame (joint local -> model space),
     // resolved from the current pose by the engine BEFORE the hierarchy pass
     // ("resolve bones before parents") so attachment-parented children read
-    // up-to-date bone transforms. Transient (never serialized).
+    // up-to-date bone transforms. Transient (never serialized). They depend only on editPose and
+    // ikSetups (IK goals/poles are joints of the same pose), so they are re-resolved only when
+    // globalsDirty is set — by whoever edits those — and only while a consumer needs them.
     std::vector<glm::mat4> currentGlobals{};
-    // frames/sec the clips were baked at; used by clipDuration(). Mirrored into
-    // AnimationPlaybackComponent::fps, which animBaseOffset() reads on the hot path.
-    float fps = 60.0f;
-
-    // Manual-posing / IK rig, retained from load so a local pose can be resolved into skinning
-    // matrices at runtime. editPose is the per-joint TRS the gizmo authors and is the one field here
-    // serialized with the map (see bagel_ecs_serialize.hpp), re-applied after the builder rebuilds
-    // the rest on rehydrate. ikSetups are NOT serialized — the "<model>.yaml" sidecar is their
-    // single source of truth, re-attached every load.
-    SkeletonData skeleton{}; // restPose / parents / inverseBind, retained for runtime resolve
+    bool globalsDirty = true;
+    // Set by the skeleton-resolve pass when some TransformHierachyComponent rides one of this
+    // entity's attach points; only such rigs are resolved eagerly each frame.
+    bool hasAttachmentChildren = false;
+
+    // Manual-posing / IK state. editPose is the per-joint TRS the gizmo authors and is the one field
+    // here serialized with the map (see bagel_ecs_serialize.hpp), re-applied after the builder
+    // rebuilds the rest on rehydrate. ikSetups start as a copy of the rig's sidecar chains and are
+    // editable per entity; they are NOT serialized — the "<model>.yaml" sidecar is their single
+    // source of truth, re-attached every load.
     Pose editPose{};         // per-joint local TRS being authored
     std::vector<IKSetup>
         ikSetups{}; // per-armature IK chains, applied on top of editPose
+
+    const SkeletonData &skeleton() const
+    {
+        static const SkeletonData empty{};
+        return rig ? rig->skeleton : empty;
+    }
+    // frames/sec the clips were baked at; mirrored into AnimationPlaybackComponent::fps, which
+    // animBaseOffset() reads on the hot path.
+    float fps() const
+    {
+        return rig ? rig->fps : 60.0f;
+    }
     uint32_t clipCount() const
     {
-        return static_cast<uint32_t>(clipFrameBases.size());
+        return rig ? static_cast<uint32_t>(rig->clipFrameBases.size()) : 0;
+    }
+    uint32_t clipFrameBase(uint32_t c) const
+    {
+        return rig->clipFrameBases[c];
+    }
+    uint32_t clipFrameCount(uint32_t c) const
+    {
+        return rig->clipFrameCounts[c];
     }
     const char *clipName(uint32_t c) const
     {
-        return (c < clipNames.size() && !clipNames[c].empty())
-                   ? clipNames[c].c_str()
+        return (rig && c < rig->clipNames.size() && !rig->clipNames[c].empty())
+                   ? rig->clipNames[c].c_str()
                    : "(unnamed)";
     }
+    // Clip index by glTF animation name, or -1.
+    int findClip(const std::string &name) const
+    {
+        if (rig)
+            for (size_t i = 0; i < rig->clipNames.size(); ++i)
+                if (rig->clipNames[i] == name)
+                    return static_cast<int>(i);
+        return -1;
+    }
     // Duration (seconds) of an ARBITRARY clip, read from the cold frame table. The hot
     // AnimationPlaybackComponent::clipDuration() covers the CURRENT clip without a vector deref.
     float clipDuration(uint32_t c) const
     {
-        return (c < clipFrameCounts.size() && clipFrameCounts[c] > 0 && fps > 0.0f)
-                   ? static_cast<float>(clipFrameCounts[c] - 1) / fps
+        return (c < clipCount() && rig->clipFrameCounts[c] > 0 && rig->fps > 0.0f)
+                   ? static_cast<float>(rig->clipFrameCounts[c] - 1) / rig->fps
                    : 0.0f;
     }
 };
 // HOT half: the lean, per-frame playback state iterated every frame by updateAnimation and the
 // animated render passes (AnimatedGBuffer/Shadow). Scalars only, no heap — so many components fit
 // per cache line. animBaseOffset() resolves the palette row from the cached current-clip window
-// below, which the builder seeds for clip 0 and which must be refreshed from AnimationComponent's
-// tables whenever `clip` changes. The heavy rig data lives in the cold AnimationComponent.
+// below, which the builder seeds for clip 0 and which must be refreshed from the rig's tables
+// whenever `clip` changes. The heavy rig data lives in the shared SkinnedRig.
 struct AnimationPlaybackComponent
 {
+    // dynamicPaletteBase before the entity is first manually posed (no region reserved yet).
+    static constexpr uint32_t NO_DYNAMIC_PALETTE = UINT32_MAX;
+
     uint32_t paletteBase =
-        0; // matrix index of (clip 0, frame 0) in the global palette SSBO
-    // Cached frame window of the CURRENT clip, copied from AnimationComponent's tables
+        0; // matrix index of (clip 0, frame 0) in the global palette SSBO — SkinnedRig::paletteBase, shared
+    // Cached frame window of the CURRENT clip, copied from the rig's tables
     // (clipFrameBases[clip] / clipFrameCounts[clip]) so the hot path never dereferences a vector.
     uint32_t clipFrameBase = 0;  // current clip: first frame row
     uint32_t clipFrameCount = 0; // current clip: baked frame count
     uint32_t jointCount = 0;
-    float fps = 60.0f; // mirror of AnimationComponent::fps for the hot path
+    float fps = 60.0f; // mirror of SkinnedRig::fps for the hot path
 
     // Playback state.
     uint32_t clip = 0;
@@ -215,19 +329,35 @@ struct AnimationPlaybackComponent
     // (dynamicPaletteBase) that the engine fills each frame by resolving the cold component's
     // editPose (+ IK), instead of a baked clip frame. poseDirty gates the re-resolve+upload so we
     // only do it on change. manualPose is the field here serialized with the map; the authored
-    // editPose it drives lives in (and is serialized from) AnimationComponent.
+    // editPose it drives lives in (and is serialized from) AnimationComponent. The region is
+    // reserved on first use by updateAnimation, so instances that only play clips cost no palette.
     bool manualPose = false; // route draws to the dynamic region when true
     uint32_t dynamicPaletteBase =
-        0;                 // base of the reserved jointCount-matrix scratch region
+        NO_DYNAMIC_PALETTE; // base of the reserved jointCount-matrix scratch region
     bool poseDirty = true; // re-resolve + re-upload editPose when set
+    // Runtime blending: set while an AnimationBlendComponent drives this entity. Its live blend is
+    // written into the same dynamic region each due frame, so draws route there too.
+    bool blended = false;
 
-    // Palette row base for the current clip/time — pushed to the shader as animBaseOffset. Snaps to
-    // the nearest baked frame (clamped to the clip's last frame); manual-posed entities read the
-    // dynamic region directly.
-    uint32_t animBaseOffset() const
+    // Animation LOD, refreshed each frame by Application::updateAnimationLOD before the skeleton
+    // resolve and updateAnimation read it. lodDue: this entity updates this frame (it is on screen,
+    // or off screen but reaching a shadow cascade, and its every-lodInterval-th frame came round). Frame time skipped while not due collects
+    // in lodPendingTime and is applied on the next due frame, so a far character plays at a lower
+    // rate but never drifts out of sync.
+    uint8_t lodInterval = 1; // update every Nth frame (1 = full rate)
+    bool lodVisible = true;  // inside the camera frustum last LOD pass
+    bool lodDue = true;
+    float lodPendingTime = 0.0f;
+
+    // Culling bounds of the pose animBaseOffset() selects (see poseBounds). frameBounds points at
+    // the shared rig's per-row table (kept alive by AnimationComponent::rig); liveBounds is written
+    // with each dynamic-region palette.
+    const AnimBounds *frameBounds = nullptr;
+    AnimBounds liveBounds{};
+
+    // Baked frame of the current clip/time, clamped into the clip's window.
+    uint32_t currentFrame() const
     {
-        if (manualPose)
-            return dynamicPaletteBase; // hand-posed: read the dynamic region
         const uint32_t frames = clipFrameCount;
         uint32_t frame = (fps > 0.0f) ? static_cast<uint32_t>(time * fps) : 0;
         // Clamp into the clip's frame window. With no baked frames (frames==0) there is nothing to
@@ -237,7 +367,59 @@ struct AnimationPlaybackComponent
             frame = 0;
         else if (frame >= frames)
             frame = frames - 1;
-        return paletteBase + (clipFrameBase + frame) * jointCount;
+        return frame;
+    }
+    bool readsDynamicRegion() const
+    {
+        return (manualPose || blended) && dynamicPaletteBase != NO_DYNAMIC_PALETTE;
+    }
+
+    // Palette row base for the current clip/time — pushed to the shader as animBaseOffset. This is
+    // the baked frame at or before `time` (clamped to the clip's last frame); the shader blends it
+    // with the next row by frameBlend(). Manual-posed entities read the dynamic region directly.
+    uint32_t animBaseOffset() const
+    {
+        // Hand-posed or live-blended: read the dynamic region (once one has been reserved; a blend
+        // keeps showing its baked frame until its first evaluation).
+        if (readsDynamicRegion())
+            return dynamicPaletteBase;
+        return paletteBase + (clipFrameBase + currentFrame()) * jointCount;
+    }
+
+    // Fraction of the way from animBaseOffset()'s row to the next one (animBaseOffset() +
+    // jointCount) — pushed as animFrameBlend so the shader interpolates between baked frames
+    // instead of stepping at the bake rate. 0 on the clip's last frame and for the dynamic region.
+    float frameBlend() const
+    {
+        if (readsDynamicRegion() || clipFrameCount < 2 || fps <= 0.0f)
+            return 0.0f;
+        const uint32_t frame = currentFrame();
+        if (frame + 1 >= clipFrameCount)
+            return 0.0f;
+        const float f = time * fps - static_cast<float>(frame);
+        return f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+    }
+
+    // Model-space bounds of the same pose, for frustum culling the animated passes. False when
+    // none are known (no bounds table, or a live pose not yet written) — draw it unculled.
+    bool poseBounds(glm::vec3 &outMin, glm::vec3 &outMax) const
+    {
+        AnimBounds b;
+        if (readsDynamicRegion())
+            b = liveBounds;
+        else if (frameBounds)
+        {
+            const uint32_t row = clipFrameBase + currentFrame();
+            b = frameBounds[row];
+            // A blended pose lies between its two rows' poses, so it is inside their union.
+            if (frameBlend() > 0.0f)
+                b.grow(frameBounds[row + 1]);
+        }
+        if (b.empty())
+            return false;
+        outMin = b.min;
+        outMax = b.max;
+        return true;
     }
 
     // Duration (seconds) of the CURRENT clip, from the cached frame window — hot path, no vector
@@ -260,39 +442,103 @@ inline void selectClip(AnimationPlaybackComponent &play, const AnimationComponen
         return;
     play.clip = c;
     play.time = 0.0f;
-    play.clipFrameBase = anim.clipFrameBases[c];
-    play.clipFrameCount = anim.clipFrameCounts[c];
+    play.clipFrameBase = anim.clipFrameBase(c);
+    play.clipFrameCount = anim.clipFrameCount(c);
 }
-// Named bone attach points baked from the model's "<model>.yaml" sidecar — the
-// Source-engine $attachment analog. Each point is a local offset (translation +
-// rotation) within a skeleton bone's space; its world transform is bone_world *
-// localOffset. Transient: the model builder rebuilds it from the sidecar on
-// load/rehydrate (not serialized — the sidecar owns it). Query via
-// lookupAttachment() / getAttachmentWorld() in bagel_hierachy.hpp. A
-// TransformHierachyComponent can name one of these to parent a child to the
-// point.
-struct AttachmentComponent
+
+// Runtime clip blending for a skinned entity: up to MAX_LAYERS clips of its rig sampled live and
+// mixed by weight, with an optional crossfade onto the newest layer. While present (and the entity
+// is not manually posed) updateAnimation evaluates every due blend on the worker pool into the
+// entity's dynamic palette region instead of reading a baked row. Start one with beginCrossfade.
+// Once a crossfade has landed on a single layer, returnToBaked hands that clip (at its current
+// time) back to baked playback and removes the component. Transient: not serialized.
+struct AnimationBlendComponent
 {
-    struct Point
+    static constexpr uint32_t MAX_LAYERS = MAX_BLEND_INPUTS;
+
+    struct Layer
     {
-        char name[MAX_ATTACHMENT_NAME] =
-            {};                      // referenced by
-                                     // TransformHierachyComponent::attachment
-                                     // / code; zero-init = valid empty
-                                     // C-string before it's filled
-        int joint = -1;              // skeleton joint the point rides (resolved from bone name)
-        glm::mat4 localOffset{1.0f}; // offset within the bone's local space
+        uint32_t clip = 0;
+        float time = 0.0f;
+        float weight = 1.0f;
+        float fadeStartWeight = 1.0f; // weight when the running crossfade began
+        bool loop = true;
+        AnimEvalContext ctx{};        // keyframe cursors, kept across frames
     };
-    std::vector<Point> points;
+    Layer layers[MAX_LAYERS]{};
+    uint32_t layerCount = 0;
+    // Running crossfade onto layers[layerCount - 1]; fadeDuration 0 = none.
+    float fadeDuration = 0.0f;
+    float fadeElapsed = 0.0f;
+    bool returnToBaked = true;
+};
 
-    // Attachment name -> index into points (or -1). Mirrors Source's
-    // LookupAttachment.
-    int lookup(const std::string &name) const
+// Crossfade `entity` onto clip `c` over `duration` seconds. The first call seeds layer 0 from the
+// current baked playback; further calls stack onto a blend still in progress, dropping the oldest
+// layer when all MAX_LAYERS are in use. A duration <= 0 cuts straight to `c`. Out-of-range `c`
+// is ignored.
+inline void beginCrossfade(AnimationPlaybackComponent &play, AnimationBlendComponent &blend,
+                           const AnimationComponent &anim, uint32_t c, float duration)
+{
+    if (c >= anim.clipCount() || !anim.rig || c >= anim.rig->clips.size())
+        return;
+    using Layer = AnimationBlendComponent::Layer;
+    if (blend.layerCount == 0)
     {
-        for (size_t i = 0; i < points.size(); ++i)
-            if (points[i].name == name)
-                return static_cast<int>(i);
-        return -1;
+        Layer &base = blend.layers[blend.layerCount++];
+        base.clip = play.clip;
+        base.time = play.time;
+        base.weight = 1.0f;
+        base.loop = play.loop;
     }
-};
+    if (duration <= 0.0f)
+        blend.layerCount = 0;
+    else if (blend.layerCount == AnimationBlendComponent::MAX_LAYERS)
+    {
+        for (uint32_t i = 1; i < blend.layerCount; ++i)
+            std::swap(blend.layers[i - 1], blend.layers[i]);
+        --blend.layerCount;
+    }
+    for (uint32_t i = 0; i < blend.layerCount; ++i)
+        blend.layers[i].fadeStartWeight = blend.layers[i].weight;
+
+    Layer &target = blend.layers[blend.layerCount++];
+    target.clip = c;
+    target.time = 0.0f;
+    target.weight = blend.layerCount == 1 ? 1.0f : 0.0f;
+    target.fadeStartWeight = target.weight;
+    target.loop = true;
+    blend.fadeDuration = blend.layerCount == 1 ? 0.0f : duration;
+    blend.fadeElapsed = 0.0f;
+    play.blended = true;
+}
+
+// Advance every layer's clock by `dt` (looping or clamping on the rig's clip durations) and the
+// crossfade with it: the newest layer's weight ramps 0 -> 1 while the others scale down from
+// where they stood. When the fade completes only the newest layer is kept.
+inline void advanceBlend(AnimationBlendComponent &blend, const SkinnedRig &rig, float dt)
+{
+    for (uint32_t i = 0; i < blend.layerCount; ++i)
+    {
+        AnimationBlendComponent::Layer &l = blend.layers[i];
+        const float dur = l.clip < rig.clips.size() ? rig.clips[l.clip].duration : 0.0f;
+        l.time += dt;
+        if (dur > 0.0f && l.time > dur)
+            l.time = l.loop ? std::fmod(l.time, dur) : dur;
+    }
+    if (blend.fadeDuration <= 0.0f || blend.layerCount == 0)
+        return;
+    blend.fadeElapsed += dt;
+    const float a = std::min(blend.fadeElapsed / blend.fadeDuration, 1.0f);
+    const uint32_t last = blend.layerCount - 1;
+    for (uint32_t i = 0; i < last; ++i)
+        blend.layers[i].weight = blend.layers[i].fadeStartWeight * (1.0f - a);
+    blend.layers[last].weight = a;
+    if (a >= 1.0f)
+    {
+        std::swap(blend.layers[0], blend.layers[last]);
+        blend.layerCount = 1;
+        blend.fadeDuration = 0.0f;
+    }
+}
 } // namespace bagel
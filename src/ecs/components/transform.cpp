@@ -1,12 +1,35 @@
 #include "transform.hpp"
 #include "imgui/bagel_imgui.hpp"
+#include "math/bagel_transform_batch.hpp"
+
+#include <array>
+#include <mutex>
+#include <utility>
+
 #define X1Y2Z3
 #define CONSOLE ConsoleApp::Instance()
 
 namespace bagel {
     // Cache the model matrix so render systems can read it via getMat4() without
 // recomputing.
-void TransformComponent::cacheMat4() { cached = computeMat4(); }
+void TransformComponent::cacheMat4() {
+  cached = computeMat4();
+  dirty = false;
+  ++version;
+}
+
+void TransformComponent::setWorldMatrix(const glm::mat4 &world) {
+  decomposeTransform(world, translation, rotation, scale);
+  // The component's own local offsets still apply on top (computeMat4 adds
+  // them); with the usual identity locals the composed matrix is exact.
+  if (localTranslation == glm::vec3(0.0f) && localRotation == glm::vec3(0.0f) &&
+      localScale == glm::vec3(1.0f))
+    cached = world;
+  else
+    cached = computeMat4();
+  dirty = false;
+  ++version;
+}
 
 // Returns mat4 with inverse scale. Mostly obsolete since normal matrix will be
 // calculated in shader;
@@ -70,44 +93,186 @@ glm::mat4 TransformComponent::computeMat4() const {
                     translation.y + localTranslation.y,
                     translation.z + localTranslation.z, 1.0f}};
 }
+namespace {
+// Lanes below this capacity are allocated and freed directly; pooling only pays
+// off for the large batches.
+constexpr uint32_t POOLED_MIN_CAPACITY = 256;
+
+std::array<std::vector<glm::vec3> *, 6> lanesOf(TransformInstanceLanes &l) {
+  return {&l.translation,      &l.scale,      &l.rotation,
+          &l.localTranslation, &l.localScale, &l.localRotation};
+}
+
+size_t laneBytes(const TransformInstanceLanes &l) {
+  return size_t(l.capacity()) * 6 * sizeof(glm::vec3);
+}
+
+// Shared recycler for TransformArrayComponent lanes. Instanced batches (foliage,
+// debris) are spawned and despawned in bulk; instead of freeing 100k-instance
+// lanes and allocating them again for the next batch, released lanes wait here
+// and the smallest one that fits is handed out. Capacities are rounded up to
+// powers of two so released lanes fit later requests, and at most
+// MAX_FREE_BYTES are kept so one unusual spike is not held forever.
+class TransformInstancePool {
+public:
+  static TransformInstancePool &get() {
+    static TransformInstancePool pool;
+    return pool;
+  }
+
+  // Empty lanes with capacity for at least n instances.
+  TransformInstanceLanes acquire(uint32_t n) {
+    uint32_t capacity = POOLED_MIN_CAPACITY;
+    while (capacity < n)
+      capacity *= 2;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t best = freeLanes.size();
+      for (size_t i = 0; i < freeLanes.size(); i++)
+        if (freeLanes[i].capacity() >= capacity &&
+            (best == freeLanes.size() ||
+             freeLanes[i].capacity() < freeLanes[best].capacity()))
+          best = i;
+      if (best != freeLanes.size()) {
+        std::swap(freeLanes[best], freeLanes.back());
+        TransformInstanceLanes lanes = std::move(freeLanes.back());
+        freeLanes.pop_back();
+        freeBytes -= laneBytes(lanes);
+        return lanes;
+      }
+    }
+    TransformInstanceLanes lanes;
+    for (std::vector<glm::vec3> *lane : lanesOf(lanes))
+      lane->reserve(capacity);
+    return lanes;
+  }
+
+  void release(TransformInstanceLanes &&lanes) {
+    if (lanes.capacity() < POOLED_MIN_CAPACITY)
+      return;
+    for (std::vector<glm::vec3> *lane : lanesOf(lanes))
+      lane->clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeBytes + laneBytes(lanes) > MAX_FREE_BYTES)
+      return;
+    freeBytes += laneBytes(lanes);
+    freeLanes.push_back(std::move(lanes));
+  }
+
+private:
+  static constexpr size_t MAX_FREE_BYTES = size_t(64) << 20;
+
+  std::mutex mutex;
+  std::vector<TransformInstanceLanes> freeLanes;
+  size_t freeBytes = 0;
+};
+
+// Move the live instances of `lanes` into pooled lanes with room for n, handing
+// the old allocation back to the pool.
+void rehomeLanes(TransformInstanceLanes &lanes, uint32_t n) {
+  TransformInstanceLanes moved = TransformInstancePool::get().acquire(n);
+  std::array<std::vector<glm::vec3> *, 6> from = lanesOf(lanes);
+  std::array<std::vector<glm::vec3> *, 6> to = lanesOf(moved);
+  for (size_t l = 0; l < from.size(); l++)
+    to[l]->assign(from[l]->begin(), from[l]->end());
+  TransformInstancePool::get().release(std::move(lanes));
+  lanes = std::move(moved);
+}
+} // namespace
+
+void TransformInstanceLanes::resize(uint32_t n) {
+  translation.resize(n, glm::vec3(0.0f));
+  scale.resize(n, glm::vec3(0.1f));
+  rotation.resize(n, glm::vec3(0.0f));
+  localTranslation.resize(n, glm::vec3(0.0f));
+  localScale.resize(n, glm::vec3(1.0f));
+  localRotation.resize(n, glm::vec3(0.0f));
+}
+
+TransformArrayComponent::~TransformArrayComponent() {
+  TransformInstancePool::get().release(std::move(lanes));
+}
+
+void TransformArrayComponent::reserve(uint32_t n) {
+  if (n <= lanes.capacity())
+    return;
+  if (n < POOLED_MIN_CAPACITY) {
+    for (std::vector<glm::vec3> *lane : lanesOf(lanes))
+      lane->reserve(n);
+    return;
+  }
+  rehomeLanes(lanes, n);
+}
+
+void TransformArrayComponent::resize(uint32_t n) {
+  const uint32_t old = count();
+  if (n > old) {
+    // At least double, so addTransform loops stay amortized linear.
+    reserve(n > old * 2 ? n : old * 2);
+    lanes.resize(n);
+    for (uint32_t i = old; i < n; i++)
+      markDirty(i);
+    return;
+  }
+  lanes.resize(n);
+  dirtyLast = dirtyLast > n ? n : dirtyLast;
+  if (dirtyFirst >= dirtyLast)
+    dirtyFirst = dirtyLast = 0;
+  // Keep memory proportional to count(): after a big shrink the survivors move
+  // to smaller lanes and the large ones go back to the pool.
+  if (lanes.capacity() > POOLED_MIN_CAPACITY && n < lanes.capacity() / 4)
+    rehomeLanes(lanes, n);
+}
+
+void TransformArrayComponent::resetTransform() {
+  resize(0);
+  resize(1);
+  dirtyFirst = 0;
+  dirtyLast = 1;
+}
+
+void TransformArrayComponent::removeLastNTransform(uint32_t n) {
+  resize(n > count() ? 0 : count() - n);
+}
+
 glm::mat4 TransformArrayComponent::mat4(uint32_t index) {
-  const float c3 = glm::cos(rotation[index].z);
-  const float s3 = glm::sin(rotation[index].z);
-  const float c2 = glm::cos(rotation[index].y);
-  const float s2 = glm::sin(rotation[index].y);
-  const float c1 = glm::cos(rotation[index].x);
-  const float s1 = glm::sin(rotation[index].x);
+  const float c3 = glm::cos(lanes.rotation[index].z);
+  const float s3 = glm::sin(lanes.rotation[index].z);
+  const float c2 = glm::cos(lanes.rotation[index].y);
+  const float s2 = glm::sin(lanes.rotation[index].y);
+  const float c1 = glm::cos(lanes.rotation[index].x);
+  const float s1 = glm::sin(lanes.rotation[index].x);
   return glm::mat4{
       {
-          scale[index].x * (c2 * c3),
-          scale[index].x * (c1 * s3 + c3 * s1 * s2),
-          scale[index].x * (s1 * s3 - c1 * c3 * s2),
+          lanes.scale[index].x * (c2 * c3),
+          lanes.scale[index].x * (c1 * s3 + c3 * s1 * s2),
+          lanes.scale[index].x * (s1 * s3 - c1 * c3 * s2),
           0.0f,
       },
       {
-          scale[index].y * (-c2 * s3),
-          scale[index].y * (c1 * c3 - s1 * s2 * s3),
-          scale[index].y * (c3 * s1 + c1 * s2 * s3),
+          lanes.scale[index].y * (-c2 * s3),
+          lanes.scale[index].y * (c1 * c3 - s1 * s2 * s3),
+          lanes.scale[index].y * (c3 * s1 + c1 * s2 * s3),
           0.0f,
       },
       {
-          scale[index].z * (s2),
-          scale[index].z * (-c2 * s1),
-          scale[index].z * (c1 * c2),
+          lanes.scale[index].z * (s2),
+          lanes.scale[index].z * (-c2 * s1),
+          lanes.scale[index].z * (c1 * c2),
           0.0f,
       },
-      {translation[index].x, translation[index].y, translation[index].z, 1.0f}};
+      {lanes.translation[index].x, lanes.translation[index].y, lanes.translation[index].z, 1.0f}};
 }
 
 // glm will convert mat3 to mat4 automatically
 glm::mat3 TransformArrayComponent::normalMatrix(uint32_t index) {
-  const float c3 = glm::cos(rotation[index].z);
-  const float s3 = glm::sin(rotation[index].z);
-  const float c2 = glm::cos(rotation[index].x);
-  const float s2 = glm::sin(rotation[index].x);
-  const float c1 = glm::cos(rotation[index].y);
-  const float s1 = glm::sin(rotation[index].y);
-  const glm::vec3 invScale = 1.0f / scale[index];
+  const float c3 = glm::cos(lanes.rotation[index].z);
+  const float s3 = glm::sin(lanes.rotation[index].z);
+  const float c2 = glm::cos(lanes.rotation[index].x);
+  const float s2 = glm::sin(lanes.rotation[index].x);
+  const float c1 = glm::cos(lanes.rotation[index].y);
+  const float s1 = glm::sin(lanes.rotation[index].y);
+  const glm::vec3 invScale = 1.0f / lanes.scale[index];
   return glm::mat3{{
                        invScale.x * (c1 * c3 + s1 * s2 * s3),
                        invScale.x * (c2 * s3),
@@ -124,34 +289,44 @@ glm::mat3 TransformArrayComponent::normalMatrix(uint32_t index) {
                        invScale.z * (c1 * c2),
                    }};
 }
-inline void TransformArrayComponent::addTransform(glm::vec3 _translation,
-                                                  glm::vec3 _scale,
-                                                  glm::vec3 _rotation) {
-  if (maxIndex < MAX_TRANSFORM_PER_ENT) {
-    _translation.y *= -1;
-    translation[maxIndex] = _translation;
-    scale[maxIndex] = _scale;
-    rotation[maxIndex] = _rotation;
-    maxIndex++;
-  } else {
-    char buff[64];
-    snprintf(buff, sizeof(buff),
-             "Transform Array Full. MAX_TRANSFORM_PER_ENT %d \n",
-             MAX_TRANSFORM_PER_ENT);
-    CONSOLE->Log("TransformArrayComponent::addTransform", buff);
-  }
+void TransformArrayComponent::setTransform(uint32_t index,
+                                           glm::vec3 _translation,
+                                           glm::vec3 _scale,
+                                           glm::vec3 _rotation) {
+  if (index >= count())
+    resize(index + 1);
+  _translation.y *= -1;
+  lanes.translation[index] = _translation;
+  lanes.scale[index] = _scale;
+  lanes.rotation[index] = _rotation;
+  markDirty(index);
+}
+
+void TransformArrayComponent::addTransform(glm::vec3 _translation,
+                                           glm::vec3 _scale,
+                                           glm::vec3 _rotation) {
+  setTransform(count(), _translation, _scale, _rotation);
 }
+
 void TransformArrayComponent::ToBufferComponent(
     DataBufferComponent &bufferComponent) {
-  for (uint32_t i = 0; i < maxIndex; i++) {
+  // A reallocated buffer starts empty: everything goes up again.
+  if (bufferComponent.reserve(count()) || !usingBuffer)
+    markAllDirty();
+  buffered.resize(count());
+  for (uint32_t i = dirtyFirst; i < dirtyLast; i++) {
     TransformBufferUnit objData{};
     objData.modelMatrix =
         mat4(i); // mat4() bakes scale in, so no separate scale field
+    buffered[i] = objData.modelMatrix;
 
     bufferComponent.writeToBuffer(&objData, sizeof(objData),
                                   i * sizeof(TransformBufferUnit));
   }
+  if (dirtyFirst < dirtyLast)
+    bufferComponent.flush();
+  dirtyFirst = dirtyLast = 0;
   bufferHandle = bufferComponent.getBufferHandle();
   usingBuffer = true;
 }
-} // namespace bagel
\ No newline at end of file
+} // namespace bagel
@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "ecs/components/data_buffer.hpp"
 #include "ecs/components/defines.h"
@@ -26,6 +27,28 @@ struct TransformComponent {
   TransformComponent(float x, float y, float z) { translation = {x, y, z}; }
   TransformComponent(glm::vec4 pos) { translation = glm::vec3(pos); }
   void cacheMat4();
+  // Store a matrix computed elsewhere from this transform's world values (the batched
+  // composeTransforms pass in Application::cacheTransforms).
+  void cacheMat4(const glm::mat4 &m) {
+    cached = m;
+    dirty = false;
+    ++version;
+  }
+  // True when a setter changed a value since the last cacheMat4(); cacheTransforms() skips
+  // clean transforms, so static props cost nothing per frame. Setters compare before writing,
+  // so passes that re-set the same value every frame (hierarchy children of a still parent,
+  // sleeping physics bodies) leave the transform clean.
+  bool isDirty() const { return dirty; }
+  void markDirty() { dirty = true; }
+  // Bumped every time the cache is rewritten (cacheMat4, setWorldMatrix). Hierarchy children
+  // compare it with the value they last composed from, which still catches a parent moved after
+  // the hierarchy pass (physics, group transforms, the inspector) once cacheTransforms() has
+  // cleared its dirty flag.
+  uint32_t cacheVersion() const { return version; }
+  // Hierarchy children: take the world matrix the hierarchy pass composed
+  // (parentWorld * local). Translation / rotation / scale are re-derived from
+  // it so the getters stay meaningful, and the cache is stored directly (clean).
+  void setWorldMatrix(const glm::mat4 &world);
   // retrieve the cached mat4 calculation result (valid only after cacheMat4()
   // this frame)
   const glm::mat4 &getMat4() const { return cached; }
@@ -38,27 +61,27 @@ struct TransformComponent {
   glm::mat3 normalMatrix();
   glm::vec3 getTranslation() const { return translation; }
   void setTranslation(const glm::vec3 &_translation) {
-    translation = _translation;
+    assign(translation, _translation);
   }
   glm::vec3 getScale() const { return scale; }
-  void setScale(const glm::vec3 &_scale) { scale = _scale; }
+  void setScale(const glm::vec3 &_scale) { assign(scale, _scale); }
   glm::vec3 getRotation() const { return rotation; }
   glm::vec3 getRotationDegrees() const {
     return {rotation.x * 180 / 3.1415926535f, rotation.y * 180 / 3.1415926535f,
             rotation.z * 180 / 3.1415926535f};
   }
-  void setRotation(const glm::vec3 &_rotation) { rotation = _rotation; }
+  void setRotation(const glm::vec3 &_rotation) { assign(rotation, _rotation); }
   void setRotationDegrees(const glm::vec3 &_rotation) {
-    rotation = {_rotation.x / 180 * 3.1415926535,
-                _rotation.y / 180 * 3.1415926535,
-                _rotation.z / 180 * 3.1415926535};
+    assign(rotation, glm::vec3(_rotation.x / 180 * 3.1415926535,
+                               _rotation.y / 180 * 3.1415926535,
+                               _rotation.z / 180 * 3.1415926535));
   }
   glm::vec3 getLocalTranslation() const { return localTranslation; }
   void setLocalTranslation(const glm::vec3 &_translation) {
-    localTranslation = _translation;
+    assign(localTranslation, _translation);
   }
   glm::vec3 getLocalScale() const { return localScale; }
-  void setLocalScale(const glm::vec3 &_scale) { localScale = _scale; }
+  void setLocalScale(const glm::vec3 &_scale) { assign(localScale, _scale); }
   glm::vec3 getLocalRotation() const { return localRotation; }
   glm::vec3 getLocalRotationDegrees() const {
     return {localRotation.x * 180 / 3.1415926535f,
@@ -66,12 +89,12 @@ struct TransformComponent {
             localRotation.z * 180 / 3.1415926535f};
   }
   void setLocalRotation(const glm::vec3 &_rotation) {
-    localRotation = _rotation;
+    assign(localRotation, _rotation);
   }
   void setLocalRotationDegrees(const glm::vec3 &_rotation) {
-    localRotation = {_rotation.x / 180 * 3.1415926535,
-                     _rotation.y / 180 * 3.1415926535,
-                     _rotation.z / 180 * 3.1415926535};
+    assign(localRotation, glm::vec3(_rotation.x / 180 * 3.1415926535,
+                                    _rotation.y / 180 * 3.1415926535,
+                                    _rotation.z / 180 * 3.1415926535));
   }
 
   glm::vec3 getWorldTranslation() const {
@@ -88,6 +111,13 @@ private:
   template <class Archive>
   friend void serialize(Archive &, TransformComponent &);
 
+  void assign(glm::vec3 &field, const glm::vec3 &value) {
+    if (field != value) {
+      field = value;
+      dirty = true;
+    }
+  }
+
   glm::vec3 translation = {0.0f, 0.0f, 0.0f};
   glm::vec3 scale = {0.1f, 0.1f, 0.1f};
   glm::vec3 rotation = {0.f, 0.f, 0.f};
@@ -98,6 +128,28 @@ private:
 
   glm::mat4 cached; // before rendering starts, all transform components cache
                     // the transform matrix here.
+  bool dirty = true; // transient: `cached` is stale. New components start dirty.
+  uint32_t version = 0; // transient: see cacheVersion()
+};
+
+// Per-instance storage of a TransformArrayComponent, one vector per field
+// (structure of arrays). Every lane has size() == count(); capacity comes from
+// the shared instance pool (see TransformArrayComponent::reserve).
+struct TransformInstanceLanes {
+  std::vector<glm::vec3> translation;
+  std::vector<glm::vec3> scale;
+  std::vector<glm::vec3> rotation;
+
+  std::vector<glm::vec3> localTranslation;
+  std::vector<glm::vec3> localScale;
+  std::vector<glm::vec3> localRotation;
+
+  uint32_t size() const { return static_cast<uint32_t>(translation.size()); }
+  uint32_t capacity() const {
+    return static_cast<uint32_t>(translation.capacity());
+  }
+  // New entries get the defaults resetTransform() used to fill in.
+  void resize(uint32_t n);
 };
 
 struct TransformArrayComponent {
@@ -106,10 +158,6 @@ struct TransformArrayComponent {
         1.0f}; // already bakes scale (see mat4()); no separate scale needed
   };
   // TransformComponent will by default hold 1 transform value
-
-  // Used to track the number of elements present
-  // Also where new data will be placed, overriding existing data
-  uint32_t maxIndex = 1;
   glm::mat4 mat4(uint32_t index = 0);
   glm::mat3 normalMatrix(uint32_t index = 0);
 
@@ -120,92 +168,122 @@ struct TransformArrayComponent {
   TransformArrayComponent() { resetTransform(); }
   TransformArrayComponent(float x, float y, float z) {
     resetTransform();
-    translation[0] = {x, y, z};
+    lanes.translation[0] = {x, y, z};
   }
   TransformArrayComponent(glm::vec4 &loc) {
     resetTransform();
-    translation[0] = glm::vec3(loc);
+    lanes.translation[0] = glm::vec3(loc);
   }
+  // Lanes go back to the shared pool, so despawning a large batch and spawning
+  // the next one reuses the allocation.
+  ~TransformArrayComponent();
+  TransformArrayComponent(const TransformArrayComponent &) = default;
+  TransformArrayComponent &operator=(const TransformArrayComponent &) = default;
+  TransformArrayComponent(TransformArrayComponent &&) noexcept = default;
+  TransformArrayComponent &
+  operator=(TransformArrayComponent &&) noexcept = default;
   bool useBuffer() const { return usingBuffer; }
 
+  // No fixed cap: both grow the lanes as needed (amortized, pool-backed).
   void addTransform(glm::vec3 _translation,
                     glm::vec3 _scale = {-0.1f, -0.1f, -0.1f},
                     glm::vec3 _rotation = {0.f, 0.f, 0.f});
+  // Writing past count() grows the array to index + 1 instances; the skipped
+  // ones hold default values.
   void setTransform(uint32_t index, glm::vec3 _translation,
                     glm::vec3 _scale = {-0.1f, -0.1f, -0.1f},
-                    glm::vec3 _rotation = {0.f, 0.f, 0.f}) {
-    if (index < MAX_TRANSFORM_PER_ENT) {
-      _translation.y *= -1;
-      translation[index] = _translation;
-      scale[index] = _scale;
-      rotation[index] = _rotation;
-    } else
-      throw(&"index out of bounds: TransformComponent::translation   "
-             "MAX_TRANSFORM_PER_ENT: "[MAX_TRANSFORM_PER_ENT]);
-  }
-  void resetTransform() {
-    translation.fill({0.f, 0.f, 0.f});
-    scale.fill({0.1f, 0.1f, 0.1f});
-    rotation.fill({0.f, 0.f, 0.f});
-    localTranslation.fill({0.f, 0.f, 0.f});
-    localScale.fill({1.0f, 1.0f, 1.0f});
-    localRotation.fill({0.f, 0.f, 0.f});
-    maxIndex = 1;
-  }
-  void removeLastNTransform(uint32_t n = 1) {
-    maxIndex = n > maxIndex ? 0 : maxIndex - n;
-  }
+                    glm::vec3 _rotation = {0.f, 0.f, 0.f});
+  // Back to a single default instance.
+  void resetTransform();
+  void removeLastNTransform(uint32_t n = 1);
+  // Set the instance count directly (new instances hold default values).
+  void resize(uint32_t n);
+  // Room for n instances without reallocating; call before bulk fills.
+  void reserve(uint32_t n);
+  // Upload the instances modified since the last call (all of them the first
+  // time, or when the buffer had to grow) and switch to the buffered path.
   void ToBufferComponent(DataBufferComponent &bufferComponent);
-  uint32_t count() const { return maxIndex; }
+  uint32_t count() const { return lanes.size(); }
+  // CPU copy of the model matrices ToBufferComponent last uploaded, one per
+  // instance: exactly what the GPU buffer holds, for per-instance culling.
+  const std::vector<glm::mat4> &bufferedMatrices() const { return buffered; }
 
-  glm::vec3 getTranslation(uint32_t i) const { return translation[i]; };
+  glm::vec3 getTranslation(uint32_t i) const { return lanes.translation[i]; };
   void setTranslation(uint32_t i, const glm::vec3 &_translation) {
-    translation[i] = _translation;
+    lanes.translation[i] = _translation;
+    markDirty(i);
   };
-  glm::vec3 getScale(uint32_t i) const { return scale[i]; }
-  void setScale(uint32_t i, const glm::vec3 &_scale) { scale[i] = _scale; };
-  glm::vec3 getRotation(uint32_t i) const { return rotation[i]; }
+  glm::vec3 getScale(uint32_t i) const { return lanes.scale[i]; }
+  void setScale(uint32_t i, const glm::vec3 &_scale) {
+    lanes.scale[i] = _scale;
+    markDirty(i);
+  };
+  glm::vec3 getRotation(uint32_t i) const { return lanes.rotation[i]; }
   void setRotation(uint32_t i, const glm::vec3 &_rotation) {
-    rotation[i] = _rotation;
+    lanes.rotation[i] = _rotation;
+    markDirty(i);
   };
 
   glm::vec3 getLocalTranslation(uint32_t i) const {
-    return localTranslation[i];
+    return lanes.localTranslation[i];
   };
   void setLocalTranslation(uint32_t i, const glm::vec3 &_translation) {
-    localTranslation[i] = _translation;
+    lanes.localTranslation[i] = _translation;
+    markDirty(i);
   };
-  glm::vec3 getLocalScale(uint32_t i) const { return localScale[i]; }
+  glm::vec3 getLocalScale(uint32_t i) const { return lanes.localScale[i]; }
   void setLocalScale(uint32_t i, const glm::vec3 &_scale) {
-    localScale[i] = _scale;
+    lanes.localScale[i] = _scale;
+    markDirty(i);
   };
-  glm::vec3 getLocalRotation(uint32_t i) const { return localRotation[i]; }
+  glm::vec3 getLocalRotation(uint32_t i) const {
+    return lanes.localRotation[i];
+  }
   void setLocalRotation(uint32_t i, const glm::vec3 &_rotation) {
-    localRotation[i] = _rotation;
+    lanes.localRotation[i] = _rotation;
+    markDirty(i);
   };
 
   glm::vec3 getWorldTranslation(uint32_t i) const {
-    return translation[i] + localTranslation[i];
+    return lanes.translation[i] + lanes.localTranslation[i];
   };
   glm::vec3 getWorldScale(uint32_t i) const {
-    return {scale[i].x * localScale[i].x, scale[i].y * localScale[i].y,
-            scale[i].z * localScale[i].z};
+    return {lanes.scale[i].x * lanes.localScale[i].x,
+            lanes.scale[i].y * lanes.localScale[i].y,
+            lanes.scale[i].z * lanes.localScale[i].z};
   };
   glm::vec3 getWorldRotation(uint32_t i) const {
-    return rotation[i] + localRotation[i];
+    return lanes.rotation[i] + lanes.localRotation[i];
   };
 
+  // Instances [begin, end) changed since the last ToBufferComponent (empty when
+  // begin >= end).
+  uint32_t dirtyBegin() const { return dirtyFirst; }
+  uint32_t dirtyEnd() const { return dirtyLast; }
+  void markDirty(uint32_t i) {
+    if (dirtyFirst >= dirtyLast) {
+      dirtyFirst = i;
+      dirtyLast = i + 1;
+      return;
+    }
+    dirtyFirst = i < dirtyFirst ? i : dirtyFirst;
+    dirtyLast = i + 1 > dirtyLast ? i + 1 : dirtyLast;
+  }
+  void markAllDirty() {
+    dirtyFirst = 0;
+    dirtyLast = count();
+  }
+
 private:
   template <class Archive>
   friend void serialize(Archive &, TransformArrayComponent &);
 
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> translation;
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> scale;
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> rotation;
-
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> localTranslation;
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> localScale;
-  std::array<glm::vec3, MAX_TRANSFORM_PER_ENT> localRotation;
+  TransformInstanceLanes lanes;
+  // Transient: see bufferedMatrices().
+  std::vector<glm::mat4> buffered;
+  // Transient: dirty instance range, see dirtyBegin().
+  uint32_t dirtyFirst = 0;
+  uint32_t dirtyLast = 0;
 };
 
 struct TransformHierachyComponent {
@@ -224,5 +302,20 @@ struct TransformHierachyComponent {
   // std::string attachment;
   char attachment[MAX_ATTACHMENT_NAME] = {}; // zero-init: valid empty C-string + deterministic bytes when serialized
   bool hasAttachment = false;
+
+  // Transient, owned by HierachySystem::ApplyHiarchialChange: the local TRS
+  // above as a matrix (rebuilt only when one of them changes), and the parent's
+  // TransformComponent::cacheVersion() this entity was last composed from, so
+  // unchanged subtrees skip.
+  glm::mat4 localMatrix{1.0f};
+  glm::vec3 cachedLocalTranslation{0.0f}, cachedLocalRotation{0.0f},
+      cachedLocalScale{1.0f};
+  bool localMatrixValid = false;
+  uint32_t parentVersion = 0;
+  // Transient: `attachment` resolved to an index into the parent's
+  // AttachmentComponent::points (-1: no such point), valid while the parent's
+  // component still has generation attachmentGeneration (0: not resolved yet).
+  int attachmentIndex = -1;
+  uint32_t attachmentGeneration = 0;
 };
 } // namespace bagel
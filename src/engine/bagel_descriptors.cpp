@@ -167,7 +167,7 @@ namespace bagel {
 
         // No VkDescriptorSetVariableDescriptorCountAllocateInfo here: the bindless layout sizes every
         // array binding up front and sets no VARIABLE_DESCRIPTOR_COUNT_BIT, so a variable count would
-        // be ignored by the spec and rejected by validation against the last binding (PALETTE, count 1).
+        // be ignored by the spec and rejected by validation against the last binding (SKINNED_VERTEX, count 1).
 
         // Might want to create a "DescriptorPoolManager" class that handles this case, and builds
         // a new pool whenever an old pool fills up. But this is beyond our current scope
@@ -240,11 +240,20 @@ namespace bagel {
             BINDINGS::SKIN, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL);
         VkDescriptorSetLayoutBinding paletteBinding = createDescriptorSetLayoutBinding(
             BINDINGS::PALETTE, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL);
+        // Per-frame instance records for instanced skinned draws.
+        VkDescriptorSetLayoutBinding skinInstanceBinding = createDescriptorSetLayoutBinding(
+            BINDINGS::SKIN_INSTANCE, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL);
+        // Compute pre-skinning: rest-vertex input + per-frame skinned-vertex output.
+        VkDescriptorSetLayoutBinding skinRestBinding = createDescriptorSetLayoutBinding(
+            BINDINGS::SKIN_REST, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL);
+        VkDescriptorSetLayoutBinding skinnedVertexBinding = createDescriptorSetLayoutBinding(
+            BINDINGS::SKINNED_VERTEX, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL);
 
         VkDescriptorBindingFlags bindFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
 
-        constexpr int bindingCount = 11;
-        std::array<VkDescriptorBindingFlags, bindingCount> flagsArray = { bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags, bindFlags };
+        constexpr int bindingCount = 14;
+        std::array<VkDescriptorBindingFlags, bindingCount> flagsArray;
+        flagsArray.fill(bindFlags);
 
         VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlags{};
         bindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
@@ -263,7 +272,10 @@ namespace bagel {
             shadowMapBinding,
             materialBinding,
             skinBinding,
-            paletteBinding };
+            paletteBinding,
+            skinInstanceBinding,
+            skinRestBinding,
+            skinnedVertexBinding };
 
         VkDescriptorSetLayoutCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -349,6 +361,27 @@ namespace bagel {
         return newHandle;
     }
 
+    void BGLBindlessDescriptorManager::rebindBuffer(uint16_t handle, VkDescriptorBufferInfo bufferInfo)
+    {
+        if (handle >= buffers.size()) {
+            assert(false && "rebindBuffer: handle out of range (slot was never stored)");
+            return;
+        }
+        buffers[handle] = bufferInfo;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.dstBinding = BINDINGS::BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        write.dstArrayElement = handle;
+        for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            write.dstSet = bindlessDescriptorSet[i];
+            vkUpdateDescriptorSets(BGLDevice::device(), 1, &write, 0, nullptr);
+        }
+    }
+
     void BGLBindlessDescriptorManager::storeMaterialTable(VkDescriptorBufferInfo bufferInfo)
     {
         VkWriteDescriptorSet write{};
@@ -394,6 +427,53 @@ namespace bagel {
         }
     }
 
+    void BGLBindlessDescriptorManager::storeSkinInstanceBuffers(
+        std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> frameBufferInfos)
+    {
+        for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.dstBinding = BINDINGS::SKIN_INSTANCE;
+            write.descriptorCount = 1;
+            write.pBufferInfo = &frameBufferInfos[i];
+            write.dstArrayElement = 0;
+            write.dstSet = bindlessDescriptorSet[i];
+            vkUpdateDescriptorSets(BGLDevice::device(), 1, &write, 0, nullptr);
+        }
+    }
+
+    void BGLBindlessDescriptorManager::storeRestVertexBuffer(VkDescriptorBufferInfo bufferInfo)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.dstBinding = BINDINGS::SKIN_REST;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        write.dstArrayElement = 0;
+        for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            write.dstSet = bindlessDescriptorSet[i];
+            vkUpdateDescriptorSets(BGLDevice::device(), 1, &write, 0, nullptr);
+        }
+    }
+
+    void BGLBindlessDescriptorManager::storeSkinnedVertexBuffers(
+        std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> frameBufferInfos)
+    {
+        for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.dstBinding = BINDINGS::SKINNED_VERTEX;
+            write.descriptorCount = 1;
+            write.pBufferInfo = &frameBufferInfos[i];
+            write.dstArrayElement = 0;
+            write.dstSet = bindlessDescriptorSet[i];
+            vkUpdateDescriptorSets(BGLDevice::device(), 1, &write, 0, nullptr);
+        }
+    }
+
     void BGLBindlessDescriptorManager::rebindTextureSampler(uint16_t handle, VkSampler newSampler)
     {
         if (handle >= textures.size()) return;
@@ -119,6 +119,9 @@ namespace bagel {
             MATERIAL    = 8,  // single storage buffer: the global material table
             SKIN        = 9,  // single storage buffer: per-vertex skin influences (joints+weights)
             PALETTE     = 10, // single storage buffer: baked joint-matrix palette
+            SKIN_INSTANCE = 11, // single storage buffer, a different one per frame: instanced skinned draws
+            SKIN_REST   = 12, // single storage buffer: rest vertices of skinned models, indexed like SKIN
+            SKINNED_VERTEX = 13, // single storage buffer, one per frame: compute pre-skinned vertices
         };
     public:
         // one sampler2DShadow per cascade at BINDINGS::SHADOW_MAP; must match SHADOW_CASCADE_COUNT in bagel_frame_info.hpp
@@ -144,6 +147,9 @@ namespace bagel {
         void storeUBOPerFrame(std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> frameBufferInfos, uint16_t targetIndex);
         // You will never be storing more than 65,535 buffers
         uint16_t storeBuffer(VkDescriptorBufferInfo bufferInfo, const char* name);
+        // Re-point an already-stored buffer slot at a different buffer (a grown replacement),
+        // keeping its handle. The caller must make sure no in-flight frame still reads the slot.
+        void rebindBuffer(uint16_t handle, VkDescriptorBufferInfo bufferInfo);
         // Bind the single global skin-table SSBO at BINDINGS::MATERIAL (not the bindless
         // array). Shaders read it directly as `skinTable.entries[rowBase + slot]`.
         void storeMaterialTable(VkDescriptorBufferInfo bufferInfo);
@@ -152,6 +158,13 @@ namespace bagel {
         // palette at BINDINGS::PALETTE (read as palette.m[animBaseOffset + jointIndex]).
         void storeSkinBuffer(VkDescriptorBufferInfo bufferInfo);
         void storePaletteBuffer(VkDescriptorBufferInfo bufferInfo);
+        // Bind each frame's skinned-instance SSBO at BINDINGS::SKIN_INSTANCE (read as
+        // skinInstances.v[gl_InstanceIndex]). Unlike the buffers above, set i gets buffer i.
+        void storeSkinInstanceBuffers(std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> frameBufferInfos);
+        // Compute pre-skinning (SkinningComputeSystem): the rest-vertex copy at BINDINGS::SKIN_REST
+        // and each frame's output vertex buffer at BINDINGS::SKINNED_VERTEX (set i gets buffer i).
+        void storeRestVertexBuffer(VkDescriptorBufferInfo bufferInfo);
+        void storeSkinnedVertexBuffers(std::array<VkDescriptorBufferInfo, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> frameBufferInfos);
 
         // Re-point one already-stored texture at a different sampler (keeps its image/view).
         // Used when the shared texture sampler is retuned live (e.g. mip LOD bias change).
@@ -7,7 +7,7 @@
 #define GLOBAL_DESCRIPTOR_COUNT 1000 // bindless descriptor table size
 #define GLOBAL_UBO_COUNT 10          // global UBO slots in the descriptor pool
 #define MAX_LIGHTS 10                // point lights uploaded per frame (mirrors the shader)
-#define MAX_TRANSFORM_PER_ENT 1000   // capacity of TransformArrayComponent's fixed arrays
+#define DATA_BUFFER_INITIAL_UNITS 1024 // starting capacity of a DataBufferComponent (it grows)
 
 // Factory defaults for the live-tunable Settings panel. Single source of truth: these
 // double as the initializers for the owning class/component members AND the values the
@@ -39,4 +39,21 @@ inline constexpr float kExposure = 0.0075f;
 inline constexpr int kSmaaEdgeMethod = 0; // 0 = luma
 inline constexpr float kSmaaEdgeThreshold = 0.05f;
 inline constexpr float kSmaaLocalContrastAdapt = 2.0f;
+// glTF animation import: keyframe reduction tolerances (see reduceClip)
+inline constexpr float kAnimPositionTolerance = 0.0005f;      // model units
+inline constexpr float kAnimRotationToleranceDegrees = 0.05f; // rotation angle
+inline constexpr float kAnimScaleTolerance = 0.0005f;
+inline constexpr bool kAnimQuantizeRotations = true; // snorm16 quaternion keys
+// Rate skinned clips are baked into resident palette rows at load. The skinned vertex shaders
+// blend the two rows around the playback time, so 15-30 fps looks smooth at a half to a quarter
+// of the 60 fps palette memory.
+inline constexpr float kAnimBakeFps = 30.0f;
+// Skinned animation LOD (Application::updateAnimationLOD). A character's projected size is its
+// bounding-sphere diameter as a fraction of the screen height; below each threshold its playback
+// and skeleton resolve run every 2nd / 4th / 8th frame. Off-screen characters are skipped.
+inline constexpr bool kAnimLodEnabled = true;
+inline constexpr float kAnimLodHalfRateSize = 0.25f;
+inline constexpr float kAnimLodQuarterRateSize = 0.10f;
+inline constexpr float kAnimLodEighthRateSize = 0.04f;
+inline constexpr float kAnimLodBoundsMargin = 1.5f; // rest-pose bounds inflation for animated reach
 } // namespace bagel::cfg
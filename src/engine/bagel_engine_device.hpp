@@ -130,7 +130,8 @@ class BGLDevice
     void beginSingleTimeCommands(VkCommandBuffer *existingBuffer);
     void endSingleTimeCommands(VkCommandBuffer commandBuffer, VkFence *fence = VK_NULL_HANDLE);
 
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
+                    VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
     void copyBufferToImage(
         VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
 
@@ -17,7 +17,7 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
         return;
 
     ImGui::Text("Animation: joints=%u  clips=%u  fps=%.1f",
-                play->jointCount, a->clipCount(), a->fps);
+                play->jointCount, a->clipCount(), a->fps());
     ImGui::Text("paletteBase=%u  dynamicBase=%u", play->paletteBase, play->dynamicPaletteBase);
 
     if (ImGui::Checkbox("Manual pose", &play->manualPose))
@@ -27,7 +27,8 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
         ImGui::SameLine();
         if (ImGui::SmallButton("Reset to rest"))
         {
-            a->editPose = a->skeleton.restPose;
+            a->editPose = a->skeleton().restPose;
+            a->globalsDirty = true;
             play->poseDirty = true;
         }
         ImGui::Text("editPose joints=%u  dirty=%s",
@@ -35,6 +36,8 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
     }
     else if (a->clipCount() > 0)
     {
+        // Seconds a clip switch crossfades over (runtime blend); 0 = cut straight to the baked clip.
+        static float crossfadeSeconds = 0.0f;
         // Clip dropdown: pick any loaded glTF animation by name and switch live.
         if (ImGui::BeginCombo("Clip", a->clipName(play->clip)))
         {
@@ -44,9 +47,17 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
                 const bool selected = (i == play->clip);
                 if (ImGui::Selectable(a->clipName(i), selected))
                 {
-                    // selectClip refreshes the hot cached frame window from the cold
-                    // tables — setting play->clip alone would leave animBaseOffset() stale.
-                    selectClip(*play, *a, i);
+                    if (crossfadeSeconds > 0.0f)
+                    {
+                        auto &blend = registry.get_or_emplace<AnimationBlendComponent>(entity);
+                        beginCrossfade(*play, blend, *a, i, crossfadeSeconds);
+                    }
+                    else
+                    {
+                        // selectClip refreshes the hot cached frame window from the cold
+                        // tables — setting play->clip alone would leave animBaseOffset() stale.
+                        selectClip(*play, *a, i);
+                    }
                 }
                 if (selected)
                     ImGui::SetItemDefaultFocus();
@@ -54,6 +65,11 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
             }
             ImGui::EndCombo();
         }
+        ImGui::SliderFloat("Crossfade (s)", &crossfadeSeconds, 0.0f, 2.0f);
+        if (const auto *blend = registry.try_get<AnimationBlendComponent>(entity))
+            for (uint32_t l = 0; l < blend->layerCount; ++l)
+                ImGui::Text("  blend %u: %s  t=%.2f  w=%.2f", l, a->clipName(blend->layers[l].clip),
+                            blend->layers[l].time, blend->layers[l].weight);
         if (ImGui::Button(play->playing ? "Pause" : "Play"))
             play->playing = !play->playing;
         ImGui::SameLine();
@@ -72,11 +88,14 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
     // ---- IK setups (applied on top of editPose while Manual pose is on) ----
     ImGui::Separator();
     ImGui::Text("IK setups (active while Manual pose is on)");
+    const SkeletonData &skel = a->skeleton();
+    // Returns true when the selection changed.
     auto boneCombo = [&](const char *label, int &ref)
     {
+        const int before = ref;
         const char *cur = "(none)";
-        if (ref >= 0 && ref < (int)a->skeleton.names.size())
-            cur = a->skeleton.names[ref].empty() ? "(unnamed)" : a->skeleton.names[ref].c_str();
+        if (ref >= 0 && ref < (int)skel.names.size())
+            cur = skel.names[ref].empty() ? "(unnamed)" : skel.names[ref].c_str();
         if (ImGui::BeginCombo(label, cur))
         {
             if (ImGui::Selectable("(none)", ref < 0))
@@ -84,8 +103,8 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
             for (int j = 0; j < (int)play->jointCount; ++j)
             {
                 ImGui::PushID(j);
-                const char *nm = (j < (int)a->skeleton.names.size() && !a->skeleton.names[j].empty())
-                                     ? a->skeleton.names[j].c_str()
+                const char *nm = (j < (int)skel.names.size() && !skel.names[j].empty())
+                                     ? skel.names[j].c_str()
                                      : "(unnamed)";
                 if (ImGui::Selectable(nm, j == ref))
                     ref = j;
@@ -93,28 +112,39 @@ void DrawAnimationComponent(entt::registry &registry, entt::entity entity)
             }
             ImGui::EndCombo();
         }
+        return ref != before;
     };
+    // Any IK edit changes the solved pose: re-resolve the globals and (in manual pose) the palette.
+    bool ikChanged = false;
     int ikRemove = -1;
     for (size_t i = 0; i < a->ikSetups.size(); ++i)
     {
         ImGui::PushID((int)(1000 + i));
         IKSetup &s = a->ikSetups[i];
         ImGui::Text("IK %d", (int)i);
-        ImGui::Checkbox("Enabled", &s.enabled);
-        boneCombo("Thigh", s.thigh);
-        boneCombo("Shin", s.shin);
-        boneCombo("Foot", s.foot);
-        boneCombo("Goal", s.goalJoint);
-        boneCombo("Pole", s.poleJoint);
-        ImGui::SliderFloat("Weight", &s.weight, 0.0f, 1.0f);
+        ikChanged |= ImGui::Checkbox("Enabled", &s.enabled);
+        ikChanged |= boneCombo("Thigh", s.thigh);
+        ikChanged |= boneCombo("Shin", s.shin);
+        ikChanged |= boneCombo("Foot", s.foot);
+        ikChanged |= boneCombo("Goal", s.goalJoint);
+        ikChanged |= boneCombo("Pole", s.poleJoint);
+        ikChanged |= ImGui::SliderFloat("Weight", &s.weight, 0.0f, 1.0f);
         if (ImGui::SmallButton("Remove"))
             ikRemove = (int)i;
         ImGui::Separator();
         ImGui::PopID();
     }
     if (ikRemove >= 0)
+    {
         a->ikSetups.erase(a->ikSetups.begin() + ikRemove);
+        ikChanged = true;
+    }
     if (ImGui::Button("Add IK setup"))
-        a->ikSetups.push_back(IKSetup{});
+        a->ikSetups.push_back(IKSetup{}); // an unset chain is invalid, so nothing to re-resolve
+    if (ikChanged)
+    {
+        a->globalsDirty = true;
+        play->poseDirty = true;
+    }
 }
 } // namespace bagel
@@ -10,7 +10,12 @@ void DrawModelComponent(entt::registry &registry, entt::entity entity)
     auto *m = registry.try_get<ModelComponent>(entity);
     if (!m)
         return;
-    ImGui::Text("Model: \"%s\"", m->loadSettings.source.c_str());
+    // Generated meshes (planets) carry no recipe; the shared model still knows its source.
+    const auto *recipe = registry.try_get<ModelRecipeComponent>(entity);
+    const char *source = recipe ? recipe->loadSettings.source.c_str()
+                         : m->model ? m->model->loadSettings.source.c_str()
+                                    : "";
+    ImGui::Text("Model: \"%s\"", source);
     if (m->model)
     {
         const Model &g = m->mesh(); // shared, cache-owned geometry
@@ -20,7 +25,7 @@ void DrawModelComponent(entt::registry &registry, entt::entity entity)
     {
         ImGui::Text("  (model not resolved)");
     }
-    ImGui::Text("  frustumCull=%s  matSources=%d", m->frustumCull ? "yes" : "no", (int)m->materialCount);
+    ImGui::Text("  frustumCull=%s  matSources=%d", m->frustumCull ? "yes" : "no", recipe ? (int)recipe->materialCount : 0);
 }
 
 void DrawWireframeComponent(entt::registry &registry, entt::entity entity)
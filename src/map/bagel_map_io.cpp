@@ -12,8 +12,9 @@ namespace bagel {
 
 	// ---- rehydrate helper ---------------------------------------------------
 	// Rebuild the GPU geometry (and generated-model materials) for every entity that
-	// carries model component T. LoadRegistry restored only loadSettings/frustumCull/
-	// materialSources; the VkBuffers + submeshes must be re-cooked from the recipe.
+	// carries model component T and its ModelRecipeComponent. LoadRegistry restored only
+	// frustumCull/skinIndex and the recipe's loadSettings/materialSources; the VkBuffers +
+	// submeshes must be re-cooked from the recipe.
 	//
 	// Ordering matters: we COLLECT every recipe, REMOVE T from all of them, and only
 	// THEN rebuild. buildComponent dedups by scanning live components for a matching
@@ -38,15 +39,15 @@ namespace bagel {
 			Pose animEditPose;
 		};
 		std::vector<Recipe> recipes;
-		for (auto [e, m] : registry.view<T>().each()) {
+		for (auto [e, m, recipe] : registry.view<T, ModelRecipeComponent>().each()) {
 			// Planet entities carry a ModelComponent (source "planet") whose geometry is rebuilt
 			// from the LOD cut by PlanetComponentSystem, NOT from a model asset — skip it here so
 			// the builder doesn't try to load a non-existent "planet" model.
 			if constexpr (std::is_same_v<T, ModelComponent>) {
 				if (registry.all_of<PlanetComponent>(e)) continue;
 			}
-			Recipe r{ e, m.loadSettings, m.frustumCull, m.skinIndex, m.materialCount,
-			          { m.materialSources, m.materialSources + m.materialCount } };
+			Recipe r{ e, recipe.loadSettings, m.frustumCull, m.skinIndex, recipe.materialCount,
+			          { recipe.materialSources, recipe.materialSources + recipe.materialCount } };
 			if constexpr (std::is_same_v<T, ModelComponent>) {
 				// Anim state is split: editPose lives on the cold AnimationComponent, manualPose on
 				// the hot AnimationPlaybackComponent. Both are (re)emplaced as a pair by buildComponent.
@@ -61,7 +62,7 @@ namespace bagel {
 		}
 
 		for (auto& r : recipes) {
-			registry.remove<T>(r.e);
+			registry.remove<T, ModelRecipeComponent>(r.e);
 			// Drop the restored AnimationComponent too, so buildComponent's emplace doesn't collide;
 			// its authored fields are saved on the recipe and re-applied below. AttachmentComponent
 			// is transient (sidecar-rebuilt) — remove() is a no-op if absent, kept for safety.
@@ -77,8 +78,9 @@ namespace bagel {
 			m.setSkin(r.skinIndex); // re-apply the saved skin (numSkins came back from the sidecar)
 			// Restore the generated-material source paths (OBJ/GLTF have materialCount == 0;
 			// their materials are re-baked into the vertex buffer by buildComponent above).
-			for (uint32_t i = 0; i < r.sources.size() && i < ModelComponent::MAX_MATERIALS; ++i)
-				m.setMaterialSource(i, r.sources[i]);
+			auto& recipe = registry.get<ModelRecipeComponent>(r.e);
+			for (uint32_t i = 0; i < r.sources.size() && i < ModelRecipeComponent::MAX_MATERIALS; ++i)
+				recipe.setMaterialSource(i, r.sources[i]);
 
 			// Re-apply the authored pose onto the freshly built AnimationComponent. editPose is only
 			// restored when its length matches the rebuilt skeleton's joint count (a changed asset
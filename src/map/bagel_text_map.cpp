@@ -119,10 +119,8 @@ namespace {
 			if (clipN && clipN.IsScalar()) {
 				uint32_t idx = clipN.as<uint32_t>(UINT32_MAX); // sentinel: not a number -> treat as a name
 				if (idx == UINT32_MAX) {
-					idx = 0;
-					const std::string &want = clipN.Scalar();
-					for (uint32_t i = 0; i < anim->clipNames.size(); ++i)
-						if (anim->clipNames[i] == want) { idx = i; break; }
+					const int found = anim->findClip(clipN.Scalar());
+					idx = found >= 0 ? static_cast<uint32_t>(found) : 0;
 				}
 				selectClip(*play, *anim, idx); // out-of-range is ignored by selectClip
 			}
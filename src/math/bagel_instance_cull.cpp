@@ -0,0 +1,32 @@
+#include "bagel_instance_cull.hpp"
+
+namespace bagel {
+
+	void cullInstances(const glm::mat4* matrices, const glm::vec3& bMin, const glm::vec3& bMax,
+	                   const Frustum* views, uint32_t viewCount, uint8_t* masks, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			glm::vec3 wMin, wMax;
+			Frustum::transformAABB(bMin, bMax, matrices[i], wMin, wMax);
+			uint8_t mask = 0;
+			for (uint32_t v = 0; v < viewCount; ++v)
+				if (views[v].testWorldAABB(wMin, wMax))
+					mask |= static_cast<uint8_t>(1u << v);
+			masks[i] = mask;
+		}
+	}
+
+	size_t compactInstances(const glm::mat4* matrices, const uint8_t* masks, size_t count, uint8_t bit,
+	                        glm::mat4* out, size_t capacity)
+	{
+		size_t written = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!(masks[i] & bit)) continue;
+			if (written < capacity) out[written] = matrices[i];
+			++written;
+		}
+		return written;
+	}
+}
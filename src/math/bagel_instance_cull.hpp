@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "math/bagel_math.hpp"
+
+namespace bagel {
+
+	// Per-instance culling for instanced batches: every instance shares one model-space AABB (the
+	// mesh bounds) and has its own model matrix. Up to 8 views (camera + shadow cascades).
+	constexpr uint32_t MAX_INSTANCE_CULL_VIEWS = 8;
+
+	// Visibility of instances [begin, end): bit v of masks[i] is set when instance i's world AABB
+	// reaches views[v]. The world box is built once per instance and tested against every view.
+	// Disjoint ranges may run concurrently.
+	void cullInstances(const glm::mat4* matrices, const glm::vec3& bMin, const glm::vec3& bMax,
+	                   const Frustum* views, uint32_t viewCount, uint8_t* masks, size_t begin, size_t end);
+
+	// Copy the matrices of the instances whose mask has `bit` to out, in instance order. Returns the
+	// number of such instances; only the first `capacity` are written, so a result above capacity
+	// means the list did not fit.
+	size_t compactInstances(const glm::mat4* matrices, const uint8_t* masks, size_t count, uint8_t bit,
+	                        glm::mat4* out, size_t capacity);
+}
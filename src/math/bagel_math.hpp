@@ -31,8 +31,18 @@ namespace bagel
 		// Uses Arvo's method to transform the AABB to world space without computing all 8 corners.
 		bool testAABB(const glm::vec3 &bMin, const glm::vec3 &bMax, const glm::mat4 &M) const
 		{
-			glm::vec3 wMin = glm::vec3(M[3]);
-			glm::vec3 wMax = glm::vec3(M[3]);
+			glm::vec3 wMin, wMax;
+			transformAABB(bMin, bMax, M, wMin, wMax);
+			return testWorldAABB(wMin, wMax);
+		}
+
+		// World-space AABB of a model-space AABB under M (Arvo). Split out so one box can be
+		// tested against several frustums (camera + shadow cascades) without redoing this.
+		static void transformAABB(const glm::vec3 &bMin, const glm::vec3 &bMax, const glm::mat4 &M,
+								  glm::vec3 &wMin, glm::vec3 &wMax)
+		{
+			wMin = glm::vec3(M[3]);
+			wMax = glm::vec3(M[3]);
 			for (int i = 0; i < 3; i++)
 			{
 				for (int j = 0; j < 3; j++)
@@ -51,6 +61,11 @@ namespace bagel
 					}
 				}
 			}
+		}
+
+		// Returns false if the world-space AABB is fully outside the frustum.
+		bool testWorldAABB(const glm::vec3 &wMin, const glm::vec3 &wMax) const
+		{
 			for (int p = 0; p < 6; p++)
 			{
 				const glm::vec3 n(planes[p]);
@@ -0,0 +1,171 @@
+#include "bagel_transform_batch.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BAGEL_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace bagel {
+
+	void TransformSoA::resize(size_t n)
+	{
+		for (std::vector<float>* lane : { &tx, &ty, &tz, &rx, &ry, &rz, &sx, &sy, &sz })
+			lane->resize(n);
+	}
+
+	// One transform; the formula every path must agree with (TransformComponent::computeMat4).
+	static inline void composeOne(const TransformSoA& in, size_t i, glm::mat4& m)
+	{
+		const float c1 = std::cos(in.rx[i]), s1 = std::sin(in.rx[i]);
+		const float c2 = std::cos(in.ry[i]), s2 = std::sin(in.ry[i]);
+		const float c3 = std::cos(in.rz[i]), s3 = std::sin(in.rz[i]);
+		const float sx = in.sx[i], sy = in.sy[i], sz = in.sz[i];
+		m[0] = glm::vec4(sx * (c2 * c3), sx * (c1 * s3 + c3 * s1 * s2), sx * (s1 * s3 - c1 * c3 * s2), 0.0f);
+		m[1] = glm::vec4(sy * (-c2 * s3), sy * (c1 * c3 - s1 * s2 * s3), sy * (c3 * s1 + c1 * s2 * s3), 0.0f);
+		m[2] = glm::vec4(sz * s2, sz * (-c2 * s1), sz * (c1 * c2), 0.0f);
+		m[3] = glm::vec4(in.tx[i], in.ty[i], in.tz[i], 1.0f);
+	}
+
+	void composeTransformsScalar(const TransformSoA& in, glm::mat4* out, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			composeOne(in, i, out[i]);
+	}
+
+	glm::mat4 composeTransform(const glm::vec3& t, const glm::vec3& r, const glm::vec3& s)
+	{
+		const float c1 = std::cos(r.x), s1 = std::sin(r.x);
+		const float c2 = std::cos(r.y), s2 = std::sin(r.y);
+		const float c3 = std::cos(r.z), s3 = std::sin(r.z);
+		glm::mat4 m;
+		m[0] = glm::vec4(s.x * (c2 * c3), s.x * (c1 * s3 + c3 * s1 * s2), s.x * (s1 * s3 - c1 * c3 * s2), 0.0f);
+		m[1] = glm::vec4(s.y * (-c2 * s3), s.y * (c1 * c3 - s1 * s2 * s3), s.y * (c3 * s1 + c1 * s2 * s3), 0.0f);
+		m[2] = glm::vec4(s.z * s2, s.z * (-c2 * s1), s.z * (c1 * c2), 0.0f);
+		m[3] = glm::vec4(t, 1.0f);
+		return m;
+	}
+
+	void decomposeTransform(const glm::mat4& m, glm::vec3& t, glm::vec3& euler, glm::vec3& scale)
+	{
+		t = glm::vec3(m[3]);
+		const glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
+		scale = { glm::length(c0), glm::length(c1), glm::length(c2) };
+		const glm::vec3 r0 = scale.x > 1e-8f ? c0 / scale.x : glm::vec3(1, 0, 0);
+		const glm::vec3 r1 = scale.y > 1e-8f ? c1 / scale.y : glm::vec3(0, 1, 0);
+		const glm::vec3 r2 = scale.z > 1e-8f ? c2 / scale.z : glm::vec3(0, 0, 1);
+		// Element M[row][col] = column[col][row]; see composeTransform for the terms.
+		euler.y = std::asin(glm::clamp(r2.x, -1.0f, 1.0f)); // M[0][2] = s2
+		euler.x = std::atan2(-r2.y, r2.z);                  // M[1][2] = -c2s1, M[2][2] = c1c2
+		euler.z = std::atan2(-r1.x, r0.x);                  // M[0][1] = -c2s3, M[0][0] = c2c3
+	}
+
+#if BAGEL_TRANSFORM_SSE2
+	// sin and cos of four angles at once: Cody-Waite reduction by pi/4 and the Cephes minimax
+	// polynomials (max error ~1 ulp for |x| < 8192, far beyond any Euler angle we store).
+	static inline void sincos4(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		// Octant index, rounded up to even so the reduced angle lands in [-pi/4, pi/4].
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		const __m128 y = _mm_cvtepi32_ps(j);
+
+		// Bit 2 of the octant flips the sine; bit 2 of (octant - 2) clear flips the cosine.
+		signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+		const __m128 signCos = _mm_castsi128_ps(
+			_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		// Bit 1 of the octant swaps the two polynomials.
+		const __m128 usePolySin = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(-1.388731625493765e-3f));
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+		pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+		pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		__m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+		ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+		ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+		ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+
+		const __m128 s = _mm_or_ps(_mm_and_ps(usePolySin, ps), _mm_andnot_ps(usePolySin, pc));
+		const __m128 c = _mm_or_ps(_mm_and_ps(usePolySin, pc), _mm_andnot_ps(usePolySin, ps));
+		outSin = _mm_xor_ps(s, signSin);
+		outCos = _mm_xor_ps(c, signCos);
+	}
+
+	void composeTransforms(const TransformSoA& in, glm::mat4* out, size_t begin, size_t end)
+	{
+		static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "composeTransforms stores mat4 columns as 4 floats");
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 s1, c1, s2, c2, s3, c3;
+			sincos4(_mm_loadu_ps(&in.rx[i]), s1, c1);
+			sincos4(_mm_loadu_ps(&in.ry[i]), s2, c2);
+			sincos4(_mm_loadu_ps(&in.rz[i]), s3, c3);
+			const __m128 sx = _mm_loadu_ps(&in.sx[i]);
+			const __m128 sy = _mm_loadu_ps(&in.sy[i]);
+			const __m128 sz = _mm_loadu_ps(&in.sz[i]);
+
+			const __m128 s1s2 = _mm_mul_ps(s1, s2);
+			const __m128 c1s2 = _mm_mul_ps(c1, s2);
+			// One register per matrix element, lane k holding that element of transform i + k.
+			__m128 col0[4] = {
+				_mm_mul_ps(sx, _mm_mul_ps(c2, c3)),
+				_mm_mul_ps(sx, _mm_add_ps(_mm_mul_ps(c1, s3), _mm_mul_ps(c3, s1s2))),
+				_mm_mul_ps(sx, _mm_sub_ps(_mm_mul_ps(s1, s3), _mm_mul_ps(c3, c1s2))),
+				_mm_setzero_ps(),
+			};
+			__m128 col1[4] = {
+				_mm_mul_ps(sy, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(c2, s3))),
+				_mm_mul_ps(sy, _mm_sub_ps(_mm_mul_ps(c1, c3), _mm_mul_ps(s1s2, s3))),
+				_mm_mul_ps(sy, _mm_add_ps(_mm_mul_ps(c3, s1), _mm_mul_ps(c1s2, s3))),
+				_mm_setzero_ps(),
+			};
+			__m128 col2[4] = {
+				_mm_mul_ps(sz, s2),
+				_mm_mul_ps(sz, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(c2, s1))),
+				_mm_mul_ps(sz, _mm_mul_ps(c1, c2)),
+				_mm_setzero_ps(),
+			};
+			__m128 col3[4] = {
+				_mm_loadu_ps(&in.tx[i]),
+				_mm_loadu_ps(&in.ty[i]),
+				_mm_loadu_ps(&in.tz[i]),
+				_mm_set1_ps(1.0f),
+			};
+
+			// Lane k of every register belongs to transform i + k: transpose each column back.
+			_MM_TRANSPOSE4_PS(col0[0], col0[1], col0[2], col0[3]);
+			_MM_TRANSPOSE4_PS(col1[0], col1[1], col1[2], col1[3]);
+			_MM_TRANSPOSE4_PS(col2[0], col2[1], col2[2], col2[3]);
+			_MM_TRANSPOSE4_PS(col3[0], col3[1], col3[2], col3[3]);
+			for (int k = 0; k < 4; ++k)
+			{
+				float* m = &out[i + k][0][0];
+				_mm_storeu_ps(m + 0, col0[k]);
+				_mm_storeu_ps(m + 4, col1[k]);
+				_mm_storeu_ps(m + 8, col2[k]);
+				_mm_storeu_ps(m + 12, col3[k]);
+			}
+		}
+		composeTransformsScalar(in, out, i, end);
+	}
+#else
+	void composeTransforms(const TransformSoA& in, glm::mat4* out, size_t begin, size_t end)
+	{
+		composeTransformsScalar(in, out, begin, end);
+	}
+#endif
+}
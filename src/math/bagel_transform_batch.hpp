@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace bagel {
+
+	// Structure-of-arrays staging for the per-frame transform finalization pass. Each lane holds
+	// the WORLD values TransformComponent::computeMat4 combines (translation + local, rotation +
+	// local in radians, scale * local), one float array per component, so the batch kernel loads
+	// the same component of four transforms with one instruction. Owned by the caller and reused
+	// between frames; resize() only allocates when the transform count grows past capacity.
+	struct TransformSoA {
+		std::vector<float> tx, ty, tz;
+		std::vector<float> rx, ry, rz;
+		std::vector<float> sx, sy, sz;
+
+		size_t size() const { return tx.size(); }
+		void resize(size_t n);
+		void set(size_t i, const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+		{
+			tx[i] = translation.x; ty[i] = translation.y; tz[i] = translation.z;
+			rx[i] = rotation.x;    ry[i] = rotation.y;    rz[i] = rotation.z;
+			sx[i] = scale.x;       sy[i] = scale.y;       sz[i] = scale.z;
+		}
+	};
+
+	// Model matrices for transforms [begin, end) of `in` into out[begin, end): the X1Y2Z3 Euler
+	// matrix with scale baked into the basis columns, same layout as computeMat4. Runs four
+	// transforms per step with SSE2 (sin/cos included) where available, scalar for the tail and on
+	// other targets. Disjoint ranges may run concurrently.
+	void composeTransforms(const TransformSoA& in, glm::mat4* out, size_t begin, size_t end);
+
+	// Scalar reference of composeTransforms (std::sin / std::cos); benchmarks compare against it.
+	void composeTransformsScalar(const TransformSoA& in, glm::mat4* out, size_t begin, size_t end);
+
+	// The same matrix for one translation / Euler XYZ rotation (radians) / scale.
+	glm::mat4 composeTransform(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+
+	// Inverse of composeTransform for an affine matrix without shear: translation, per-axis scale
+	// (basis column lengths) and the X1Y2Z3 Euler angles that rebuild its rotation.
+	void decomposeTransform(const glm::mat4& m, glm::vec3& translation, glm::vec3& rotation, glm::vec3& scale);
+}
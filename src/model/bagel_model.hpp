@@ -6,10 +6,13 @@
 #include <glm/glm.hpp>
 #include <string>
 #include <map>
+#include <memory>
 #include "engine/bagel_engine_device.hpp"
 
 namespace bagel
 {
+	struct SkinnedRig; // ecs/components/model.hpp — shared skeleton + baked palette of a skinned Model
+
 	// Magic hash function from boost, modified to return same value for same vertex
 	inline void Hash(std::size_t &seed, const float &v)
 	{
@@ -96,7 +99,7 @@ namespace bagel
 	// SkeletonData / JointTransform / AnimationClip live in animation/bagel_animation.hpp
 	// (included above) — the loader fills them, the animation module consumes them.
 	// ComponentBuildMode and ModelLoadSettings now live in model_load_settings.hpp
-	// (included above) so ModelComponent can store/serialize the load recipe.
+	// (included above) so ModelRecipeComponent can store/serialize the load recipe.
 	namespace BGLModel
 	{
 		struct Material
@@ -209,6 +212,10 @@ namespace bagel
 		// global per-vertex skin-influence SSBO; the shader reads v[skinVertexBase + gl_VertexIndex].
 		bool isSkinned = false;
 		uint32_t skinVertexBase = 0;
+		// Skeleton, baked clip tables and resident palette rows, built once with the model and
+		// shared (not copied) by every instance's AnimationComponent, which sees it read-only. Held
+		// mutable here only so palette compaction can relocate paletteBase. Null for static models.
+		std::shared_ptr<SkinnedRig> rig;
 
 		glm::vec3 aabbMin{0.0f};
 		glm::vec3 aabbMax{0.0f};
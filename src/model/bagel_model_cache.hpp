@@ -37,6 +37,12 @@ namespace bagel {
 
 		size_t size() const { return models_.size(); }
 
+		// Visit every cached Model (e.g. to patch skin/palette bases after BGLSkinManager compaction).
+		template<class Fn>
+		void forEach(Fn&& fn) {
+			for (auto& [key, model] : models_) fn(*model);
+		}
+
 	private:
 		ModelCacheManager() = default;
 		ModelCacheManager(const ModelCacheManager&) = delete;
@@ -23,7 +23,8 @@ void ModelComponentBuilder::createVertexBufferStaged(size_t bufferSize, void *bu
 
     bglDevice.createBuffer(
         bufferSize,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        // TRANSFER_SRC: BGLSkinManager::copyRestVertices reads skinned models back out.
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         bufferDst,
         memoryDst);
@@ -78,7 +79,7 @@ void ModelComponentBuilder::createMappableBuffer(size_t bufferSize, VkBufferUsag
 void *ModelComponentBuilder::createVertexBufferMapped(size_t bufferSize, void *bufferSrc, VkBuffer &bufferDst, VkDeviceMemory &memoryDst)
 {
     void *mapped;
-    createMappableBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, "vertex", bufferDst, memoryDst);
+    createMappableBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, "vertex", bufferDst, memoryDst);
     vkMapMemory(BGLDevice::device(), memoryDst, 0, VK_WHOLE_SIZE, 0, &mapped);
     // Write vertex data straight into the mapped buffer
     assert(mapped && "Cannot copy to unmapped buffer");
@@ -19,7 +19,6 @@ void ModelComponentBuilder::buildComponent(ModelComponent &mc, const char *model
     Model &model = cache.create(std::string(modelFileName));
     mc.model = &model;
     model.loadSettings.source = modelFileName; // source path = the model's identity / cache key
-    mc.loadSettings.source = modelFileName;
 
     // Model-space AABB (used for frustum culling).
     computeModelBounds(model, verts);
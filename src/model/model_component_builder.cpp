@@ -2,6 +2,7 @@
 #include "model_loaders/generated.hpp"
 #include "model_loaders/gltf.hpp"
 #include "model_loaders/obj.hpp"
+#include "imgui/bagel_imgui.hpp" // CONSOLE
 
 // vulkan headers
 #include <stdexcept>
@@ -146,8 +147,10 @@ void ModelComponentBuilder::loadModel(const char *filename, ModelLoadSettings bu
 ModelComponent &ModelComponentBuilder::buildComponent(entt::entity targetEnt, const char *modelFileName, ModelLoadSettings buildSettings)
 {
     ModelComponent &comp = registry.emplace<ModelComponent>(targetEnt);
-    comp.loadSettings = buildSettings;
-    comp.loadSettings.source = modelFileName; // source path = the model's identity / cache key
+    // The recipe goes in its own cold component so the hot ModelComponent pool stays small.
+    ModelRecipeComponent &recipe = registry.emplace<ModelRecipeComponent>(targetEnt);
+    recipe.loadSettings = buildSettings;
+    recipe.loadSettings.source = modelFileName; // source path = the model's identity / cache key
 
     ModelCacheManager &cache = ModelCacheManager::get();
     const std::string key = modelFileName;
@@ -157,19 +160,16 @@ ModelComponent &ModelComponentBuilder::buildComponent(entt::entity targetEnt, co
         // Cache hit: share the existing geometry. Non-skinned instances are fully
         // described by the shared Model, so there's nothing else to do.
         comp.model = cached;
-        if (!cached->isSkinned)
+        if (!cached->isSkinned || !cached->rig)
             return comp;
-        // Skinned duplicate (rare — skinned models are usually single-instance): the
-        // influences/geometry are shared, but each entity needs its own AnimationComponent.
-        // Re-parse the source for skeleton/clips (no buffers created) and bake playback state.
-        loadModel(modelFileName, buildSettings);
-        attachSkinningState(targetEnt);
-        activeLoader.reset();
+        // Skinned instance: geometry, influences and the baked palette all live on the shared
+        // Model, so only this entity's playback state is created — no re-parse, no re-bake.
+        attachSkinningState(targetEnt, cached->rig);
         return comp;
     }
 
     Model &model = cache.create(key);
-    model.loadSettings = comp.loadSettings;
+    model.loadSettings = recipe.loadSettings;
     comp.model = &model;
 
     loadModel(modelFileName, buildSettings);
@@ -200,14 +200,42 @@ ModelComponent &ModelComponentBuilder::buildComponent(entt::entity targetEnt, co
     model.numSlots = static_cast<uint16_t>(activeLoader->getNumSlots());
     model.numSkins = static_cast<uint8_t>(activeLoader->getNumSkins());
 
-    // Skeletal skinning: upload per-vertex influences ONCE for the shared model, then bake
-    // this entity's animation/playback state (a per-entity AnimationComponent).
+    // Skeletal skinning: upload per-vertex influences and bake the clips ONCE for the shared
+    // model, then attach this entity's playback state (a per-entity AnimationComponent).
+    // When either SSBO is full (even after compaction) the model loads unskinned: it draws its
+    // bind pose through the static passes instead of indexing past the buffers.
     if (pSkinManager && activeLoader->isSkinned())
     {
         auto &infl = activeLoader->getSkinInfluences();
-        model.skinVertexBase = pSkinManager->uploadInfluences(infl.data(), static_cast<uint32_t>(infl.size()));
-        model.isSkinned = true;
-        attachSkinningState(targetEnt);
+        const uint32_t skinVertexBase = pSkinManager->uploadInfluences(infl.data(), static_cast<uint32_t>(infl.size()));
+        if (skinVertexBase == BGLSkinManager::INVALID_BASE)
+        {
+            CONSOLE->Log("ModelComponentBuilder", std::string("skin influence buffer full; ") + modelFileName +
+                                                      " loads unskinned (" + std::to_string(infl.size()) + " vertices)");
+        }
+        else
+        {
+            model.skinVertexBase = skinVertexBase;
+            static_assert(sizeof(BGLModel::Vertex) == BGLSkinManager::REST_VERTEX_STRIDE, "rest-vertex copy must match the vertex format");
+            assert(infl.size() == vertices.size() && "one skin influence per vertex");
+            pSkinManager->uploadRestVertices(model.skinVertexBase, vertices.data(), static_cast<uint32_t>(vertices.size()));
+            // Set before the palette upload: a compaction it triggers must relocate skinVertexBase.
+            model.isSkinned = true;
+            std::shared_ptr<SkinnedRig> rig = buildSkinnedRig();
+            if (rig->paletteBase == BGLSkinManager::INVALID_BASE)
+            {
+                CONSOLE->Log("ModelComponentBuilder", std::string("joint palette buffer full; ") + modelFileName +
+                                                          " loads unskinned");
+                pSkinManager->releaseInfluences(model.skinVertexBase);
+                model.isSkinned = false;
+                model.skinVertexBase = 0;
+            }
+            else
+            {
+                model.rig = std::move(rig);
+                attachSkinningState(targetEnt, model.rig);
+            }
+        }
     }
     activeLoader.reset();
     std::cout << "Finished building Component\n";
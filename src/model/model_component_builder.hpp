@@ -67,55 +67,94 @@ class ModelComponentBuilder
     // destroying either entity frees nothing GPU-side (no more owner/borrower double-free).
     ModelComponent &buildComponent(entt::entity targetEnt, const char *modelFileName, ModelLoadSettings buildSettings);
 
-    // Bake a skinned entity's animation state from the currently-loaded activeLoader (skeleton +
-    // clips): emplaces an AnimationComponent (playback + baked palette layout) and, if the
-    // sidecar defines any, an AttachmentComponent. The model's shared skin offsets
-    // (skinVertexBase/isSkinned) are set by the caller before this runs. Called on first build
-    // and again for each (rare) skinned duplicate. Requires activeLoader loaded, pSkinManager set.
-    void attachSkinningState(entt::entity targetEnt)
+    // Build the shared rig of a skinned Model from the currently-loaded activeLoader (skeleton +
+    // clips + sidecar): bake every clip and upload the rows into the resident palette region ONCE.
+    // The result is stored on the Model (Model::rig) and referenced by all its instances. Requires
+    // activeLoader loaded, pSkinManager set.
+    std::shared_ptr<SkinnedRig> buildSkinnedRig()
     {
-        BakedAnimation baked = bakeClips(activeLoader->getSkeleton(), activeLoader->getAnimations());
+        const SkeletonData &skel = activeLoader->getSkeleton();
+        const auto &clips = activeLoader->getAnimations();
 
-        // Hot per-frame playback state (iterated every frame by updateAnimation + the animated
-        // render passes) is split from the cold rig data (skeleton/pose/IK + per-clip tables).
-        // They're separate EnTT pools, so holding both references across the two emplaces is safe.
-        AnimationPlaybackComponent &play = registry.emplace<AnimationPlaybackComponent>(targetEnt);
-        AnimationComponent &anim = registry.emplace<AnimationComponent>(targetEnt);
+        auto rig = std::make_shared<SkinnedRig>();
+        // Bind-space box per joint over the vertices it influences: the input skinnedBounds turns
+        // into a conservative box for any pose, so skinned meshes can be frustum culled.
+        const auto &verts = activeLoader->getVertices();
+        const auto &infl = activeLoader->getSkinInfluences();
+        rig->jointBounds.resize(skel.jointCount());
+        for (size_t v = 0; v < verts.size() && v < infl.size(); ++v)
+            for (int k = 0; k < 4; ++k)
+                if (infl[v].weights[k] > 0 && infl[v].joints[k] < rig->jointBounds.size())
+                    rig->jointBounds[infl[v].joints[k]].grow(verts[v].position);
 
-        play.jointCount = baked.jointCount;
-        play.fps = baked.fps;
-        anim.fps = baked.fps; // mirrored: clipDuration() (cold) needs it too
-        anim.clipFrameBases = baked.clipFrameBase;
-        anim.clipFrameCounts = baked.clipFrameCount;
-        // Seed the hot component's cached current-clip window (clip 0). animBaseOffset() reads
-        // these scalars, not the tables — refresh them whenever `clip` changes (selectClip).
-        if (!baked.clipFrameCount.empty())
-        {
-            play.clipFrameBase = baked.clipFrameBase[0];
-            play.clipFrameCount = baked.clipFrameCount[0];
-        }
+        BakedAnimation baked = bakeClips(skel, clips, cfg::kAnimBakeFps, &rig->jointBounds);
+        rig->jointCount = baked.jointCount;
+        rig->fps = baked.fps;
+        rig->clipFrameBases = std::move(baked.clipFrameBase);
+        rig->clipFrameCounts = std::move(baked.clipFrameCount);
+        rig->frameBounds = std::move(baked.frameBounds);
         // Carry the glTF animation names alongside the baked frame table (same clip order).
-        {
-            const auto &clips = activeLoader->getAnimations();
-            anim.clipNames.reserve(clips.size());
-            for (const auto &c : clips)
-                anim.clipNames.push_back(c.name);
-        }
+        rig->clipNames.reserve(clips.size());
+        for (const auto &c : clips)
+            rig->clipNames.push_back(c.name);
         // With clips, paletteBase points at the baked resident region. With NO clips, bake a
         // single bind/rest-pose palette and point paletteBase at it — otherwise animBaseOffset()
         // returns paletteBase=0, an unwritten palette region, and every vertex collapses to the
         // origin (the model renders invisible). A clip-less skinned model should show its rest pose.
         if (!baked.matrices.empty())
         {
-            play.paletteBase = pSkinManager->uploadPalette(
+            rig->paletteBase = pSkinManager->uploadPalette(
                 baked.matrices.data(), static_cast<uint32_t>(baked.matrices.size()));
         }
-        else if (play.jointCount > 0)
+        else if (rig->jointCount > 0)
         {
-            const SkeletonData &skel = activeLoader->getSkeleton();
-            std::vector<glm::mat4> restPalette(play.jointCount);
+            std::vector<PaletteMatrix> restPalette(rig->jointCount);
             resolvePalette(skel, skel.restPose, restPalette.data());
-            play.paletteBase = pSkinManager->uploadPalette(restPalette.data(), play.jointCount);
+            rig->paletteBase = pSkinManager->uploadPalette(restPalette.data(), rig->jointCount);
+            rig->frameBounds.assign(1, skinnedBounds(rig->jointBounds, restPalette.data()));
+        }
+
+        // Manual posing keeps the skeleton at runtime to resolve edited poses; runtime blending
+        // keeps the source curves to sample them live.
+        rig->skeleton = skel;
+        rig->clips = clips;
+        // IK chains and attach points come from the "<model>.yaml" sidecar (bone names resolved
+        // to joint indices now that the skeleton is parsed). These are NOT serialized with the
+        // map — the sidecar is their single source of truth — so they're (re)attached on every
+        // load/rehydrate. Only the authored pose (editPose) persists in the map.
+        rig->ikSetups = activeLoader->resolveIkSetups();
+        rig->attachments = activeLoader->resolveAttachments();
+
+        std::cout << "Skinned model: " << rig->jointCount << " joints, "
+                  << rig->clipNames.size() << " clip(s), " << baked.matrices.size() << " palette matrices\n";
+        return rig;
+    }
+
+    // Attach per-entity animation state for an instance of a skinned Model: emplaces the hot
+    // AnimationPlaybackComponent + cold AnimationComponent pointing at the shared `rig`, and an
+    // AttachmentComponent if the sidecar defines any attach points. No parsing, baking or palette
+    // upload happens here, so each further instance of a rig costs only its playback state.
+    void attachSkinningState(entt::entity targetEnt, std::shared_ptr<const SkinnedRig> rig)
+    {
+        // Hot per-frame playback state (iterated every frame by updateAnimation + the animated
+        // render passes) is split from the cold rig data (skeleton/pose/IK + per-clip tables).
+        // They're separate EnTT pools, so holding both references across the two emplaces is safe.
+        AnimationPlaybackComponent &play = registry.emplace<AnimationPlaybackComponent>(targetEnt);
+        AnimationComponent &anim = registry.emplace<AnimationComponent>(targetEnt);
+
+        play.jointCount = rig->jointCount;
+        play.fps = rig->fps;
+        play.paletteBase = rig->paletteBase;
+        play.frameBounds = rig->frameBounds.empty() ? nullptr : rig->frameBounds.data();
+        // Seed the hot component's cached current-clip window (clip 0). animBaseOffset() reads
+        // these scalars, not the tables — refresh them whenever `clip` changes (selectClip).
+        if (!rig->clipFrameCounts.empty())
+        {
+            play.clipFrameBase = rig->clipFrameBases[0];
+            play.clipFrameCount = rig->clipFrameCounts[0];
+        }
+        else if (play.jointCount > 0)
+        {
             // Clip-less rig (e.g. the IK leg): present the single uploaded rest-pose palette as a
             // 1-frame clip and stop playback. Otherwise clipFrameCount stays 0, animBaseOffset()'s
             // frame clamp is skipped, and advancing `time` runs the palette index off the end of
@@ -124,35 +163,19 @@ class ModelComponentBuilder
             play.clipFrameCount = 1;
             play.playing = false;
         }
-        else
-        {
-            play.paletteBase = 0;
-        }
-
-        // Manual posing: keep the skeleton at runtime, seed an editable pose from rest,
-        // and reserve a dynamic palette region the engine overwrites when manualPose is on.
-        anim.skeleton = activeLoader->getSkeleton();
-        anim.editPose = anim.skeleton.restPose;
-        if (play.jointCount > 0)
-            play.dynamicPaletteBase = pSkinManager->reservePalette(play.jointCount);
 
-        // IK chains come from the "<model>.yaml" sidecar (bone names resolved to joint
-        // indices now that the skeleton is parsed). These are NOT serialized with the map —
-        // the sidecar is their single source of truth — so they're (re)attached on every
-        // load/rehydrate. Only the authored pose (editPose) persists in the map.
-        anim.ikSetups = activeLoader->resolveIkSetups();
+        // Manual posing: seed an editable pose from rest. The dynamic palette region it is
+        // resolved into is reserved lazily, the first time the entity is manually posed.
+        anim.editPose = rig->skeleton.restPose;
+        anim.ikSetups = rig->ikSetups;
 
-        // Attach points from the same sidecar (also transient / sidecar-owned). Only added
-        // when the model defines any, so unattached models stay AttachmentComponent-free.
-        auto attachPoints = activeLoader->resolveAttachments();
-        if (!attachPoints.empty())
+        // Only added when the model defines any, so unattached models stay AttachmentComponent-free.
+        if (!rig->attachments.empty())
         {
             auto &ac = registry.emplace<AttachmentComponent>(targetEnt);
-            ac.points = std::move(attachPoints);
+            ac.points = rig->attachments;
         }
-
-        std::cout << "Skinned model: " << baked.jointCount << " joints, "
-                  << anim.clipCount() << " clip(s)\n";
+        anim.rig = std::move(rig);
     }
 
     void configureModelMaterialSet(std::vector<GLTFMaterial> *set);
@@ -174,8 +197,8 @@ class ModelComponentBuilder
         pMaterialManager = mm;
     }
     // Optional: set before buildComponent() to enable skeletal skinning. When a loaded model
-    // carries skin influences, the builder uploads them + the baked palette here and attaches
-    // an AnimationComponent. Without it, skinned models load as static (no skinning).
+    // carries skin influences, the builder uploads them + the baked palette here (once per Model)
+    // and attaches an AnimationComponent. Without it, skinned models load as static (no skinning).
     void setSkinManager(BGLSkinManager *sm)
     {
         pSkinManager = sm;
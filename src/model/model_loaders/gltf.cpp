@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <unordered_map>
 #include "bagel_util.hpp"
+#include "engine/bagel_engine_config.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -358,6 +359,9 @@ namespace bagel
 				auto it = nodeToJoint.find(child);
 				if (it != nodeToJoint.end()) skeleton.parents[it->second] = static_cast<int>(j);
 			}
+		// Parent-before-child walk order for resolveGlobals, computed once here rather than
+		// rediscovered on every resolve.
+		buildJointOrder(skeleton);
 
 		printf("[GLTF] skin parsed: %zu joints\n", jointCount);
 	}
@@ -371,6 +375,10 @@ namespace bagel
 		std::unordered_map<int, int> nodeToJoint;
 		for (size_t j = 0; j < skin.joints.size(); j++) nodeToJoint[skin.joints[j]] = static_cast<int>(j);
 
+		// Import-time compression: drop keys interpolation rebuilds within tolerance and quantize
+		// rotations. The tolerances live in the engine config (AnimReduceSettings' defaults).
+		const AnimReduceSettings reduce{};
+
 		for (const tinygltf::Animation& anim : model.animations)
 		{
 			AnimationClip clip;
@@ -413,6 +421,10 @@ namespace bagel
 				clip.channels.push_back(ac);
 			}
 
+			const AnimReduceStats rs = reduceClip(clip, reduce);
+			printf("[GLTF] clip '%s': keys %zu -> %zu, %zu -> %zu bytes (%.2fx), max error pos %.5f rot %.4f deg scale %.5f\n",
+			       clip.name.c_str(), rs.keysBefore, rs.keysAfter, rs.bytesBefore, rs.bytesAfter, rs.ratio(),
+			       rs.maxPositionError, glm::degrees(rs.maxRotationError), rs.maxScaleError);
 			animations.push_back(std::move(clip));
 		}
 
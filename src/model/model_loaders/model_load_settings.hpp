@@ -2,7 +2,7 @@
 
 // Lightweight, dependency-free definition of the model "recipe": the settings that
 // fully describe how to (re)build a model from its source asset. Pulled out of
-// bagel_model_loader.hpp so ModelComponent (in bagel_ecs_components.hpp) can store
+// bagel_model_loader.hpp so ModelRecipeComponent (in bagel_ecs_components.hpp) can store
 // and serialize it without dragging in xatlas / the texture loader.
 
 #include <cstdint>
@@ -401,9 +401,9 @@ void MyApplication::placeCubes()
         auto &tfc = registry.emplace<TransformComponent>(entity);
         tfc.setTranslation(def.pos);
         tfc.setScale(def.scale);
-        auto &model = modelBuilder.buildComponent(entity, "/models/cube.obj", ComponentBuildMode::FACES);
+        modelBuilder.buildComponent(entity, "/models/cube.obj", ComponentBuildMode::FACES);
         // Record the material source so the brick look survives a save/load round trip.
-        model.setMaterialSource(0, bricksSrc);
+        registry.get<ModelRecipeComponent>(entity).setMaterialSource(0, bricksSrc);
     }
 }
 void MyApplication::buildHierarchyStack()
@@ -544,11 +544,12 @@ void MyApplication::loadSponzaStress()
 // a single storage buffer (TransformArrayComponent -> DataBufferComponent). This trades
 // 1000 entities and 1000 draws for one of each — the instanced path in the gbuffer render
 // system (view<TransformArrayComponent, ModelComponent>) uses transform.count() as the
-// instance count and reads the matrices via BufferedTransformHandle. No per-submesh frustum
-// culling here (the whole batch is one draw), so keep the count at MAX_TRANSFORM_PER_ENT.
+// instance count and reads the matrices via BufferedTransformHandle. InstanceCullSystem culls
+// each instance against the camera and every cascade (whole-model bounds; there is no
+// per-submesh culling inside a batch), so off-screen copies cost nothing to draw.
 void MyApplication::loadSponzaInstanced()
 {
-    constexpr int SPONZA_INSTANCE_COUNT = MAX_TRANSFORM_PER_ENT; // buffer capacity == array capacity
+    constexpr int SPONZA_INSTANCE_COUNT = 1000;                  // same grid as loadSponzaStress
     constexpr int SIDE = 32;                                     // grid columns; rows = COUNT/SIDE
     constexpr float SPACING = 40.0f;                             // Sponza is ~30 units wide at 0.01 scale
     constexpr float SCALE = 0.01f;
@@ -565,8 +566,9 @@ void MyApplication::loadSponzaInstanced()
     builder.buildComponent(e, "/models/sponza/Sponza.gltf", settings);
 
     // Fill one TransformArrayComponent with the whole grid, then bake it into a GPU
-    // storage buffer. setTransform writes an index in place; maxIndex is the instance count.
+    // storage buffer. setTransform writes an index in place, growing the array as needed.
     auto &tac = registry.emplace<TransformArrayComponent>(e);
+    tac.reserve(SPONZA_INSTANCE_COUNT);
     const float half = (SIDE - 1) * 0.5f;
     for (int i = 0; i < SPONZA_INSTANCE_COUNT; i++)
     {
@@ -576,7 +578,6 @@ void MyApplication::loadSponzaInstanced()
                           static_cast<float>(i / SIDE) * SPACING - half * SPACING},
                          {SCALE, SCALE, SCALE});
     }
-    tac.maxIndex = SPONZA_INSTANCE_COUNT;
 
     // The DataBufferComponent owns the mapped GPU buffer + bindless handle; it must live on
     // the entity so it outlives this call. ToBufferComponent writes the matrices and flips
@@ -584,7 +585,7 @@ void MyApplication::loadSponzaInstanced()
     auto &dbc = registry.emplace<DataBufferComponent>(
         e, bglDevice, *descriptorManager,
         static_cast<uint32_t>(sizeof(TransformArrayComponent::TransformBufferUnit)),
-        "SponzaInstancedTransforms");
+        "SponzaInstancedTransforms", SPONZA_INSTANCE_COUNT);
     tac.ToBufferComponent(dbc);
 
     // Match loadSponzaStress's vantage point.
@@ -200,6 +200,7 @@ namespace bagel {
         }
         auto& animP = registry.get<AnimationPlaybackComponent>(target);
 		animP.poseDirty = true;
+		anim.globalsDirty = true;
 	}
 
 	void PoseGizmo::update(GLFWwindow* window, const BGLCamera& camera, float vpW, float vpH)
@@ -232,15 +233,15 @@ namespace bagel {
 		auto& tc   = registry.get<TransformComponent>(target);
         auto &anim = registry.get<AnimationComponent>(target);
         auto& animP = registry.get<AnimationPlaybackComponent>(target);
-		if (animP.jointCount == 0 || anim.skeleton.empty()) return;
+		if (animP.jointCount == 0 || anim.skeleton().empty()) return;
 
 		// Resolve joint world positions for this frame from the IK-corrected pose (editPose + IK),
 		// the same final pose the GPU palette bakes — so markers/handles sit on the bones' actual
 		// posed positions, not the pre-IK authored ones.
 		entityModel = tc.computeMat4();
 		Pose displayPose;
-		applyManualPose(anim.skeleton, anim.editPose, anim.ikSetups, displayPose);
-		resolveGlobals(anim.skeleton, displayPose, globals);
+		applyManualPose(anim.skeleton(), anim.editPose, anim.ikSetups, displayPose);
+		resolveGlobals(anim.skeleton(), displayPose, globals);
 		const int n = static_cast<int>(animP.jointCount);
 		jointWorldPos.resize(n);
 		jointWorldMat.resize(n);
@@ -248,7 +249,7 @@ namespace bagel {
 			jointWorldMat[j] = entityModel * globals[j];
 			jointWorldPos[j] = glm::vec3(jointWorldMat[j][3]);
 		}
-		parentsCache = anim.skeleton.parents; // expose hierarchy to the render system (bone lines)
+		parentsCache = anim.skeleton().parents; // expose hierarchy to the render system (bone lines)
 
 		// Drop any selections that fell out of range (e.g. target swap), then recompute the batch
 		// pivot as the centroid of the selected joints' world positions.
@@ -303,8 +304,8 @@ namespace bagel {
 		mouseLeftPrev = mouseLeft;
 
 		// Cache the selected bone's name for the overlay/UI.
-		selJointName = (selJoint >= 0 && selJoint < static_cast<int>(anim.skeleton.names.size()))
-			? anim.skeleton.names[selJoint] : std::string{};
+		selJointName = (selJoint >= 0 && selJoint < static_cast<int>(anim.skeleton().names.size()))
+			? anim.skeleton().names[selJoint] : std::string{};
 	}
 
 } // namespace bagel
@@ -9,6 +9,8 @@
 #include "math/bagel_math.hpp"
 #include "ecs/components/model.hpp"
 #include "ecs/components/transform.hpp"
+#include "compute_systems/skinning_compute_system.hpp"
+#include "imgui/bagel_imgui.hpp"
 
 namespace bagel {
 
@@ -16,10 +18,12 @@ namespace bagel {
 		VkRenderPass renderPass,
 		std::vector<VkDescriptorSetLayout> setLayouts,
 		std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
+		BGLSkinManager& _skinManager,
 		entt::registry& _registry)
 		: BGLRenderSystem{ renderPass, setLayouts, sizeof(SkinnedGBufferPushConstantData) }
 		, registry{ _registry }
 		, descriptorManager{ _descriptorManager }
+		, skinManager{ _skinManager }
 	{
 		std::cout << "Creating Skinned GBuffer Render System\n";
 		// Reuses the static G-buffer fragment shader; only the vertex shader skins.
@@ -29,7 +33,7 @@ namespace bagel {
 			BGLPipeline::setupGBufferPipeline);
 	}
 
-	void AnimatedGBufferRenderSystem::renderEntities(FrameInfo& frameInfo)
+	void AnimatedGBufferRenderSystem::renderEntities(FrameInfo& frameInfo, const PreSkinnedFrame* preSkinned)
 	{
 		const Frustum& frustum = frameInfo.cameraFrustum;
 
@@ -48,35 +52,53 @@ namespace bagel {
 		// animBaseOffset() reads its cached scalars, so the cold AnimationComponent is never loaded.
 		// Read-only over animation state: time is advanced once per frame in the engine loop
 		// (before shadow + g-buffer) so both passes sample the same pose.
+		batcher.clear();
 		auto view = registry.view<TransformComponent, ModelComponent, AnimationPlaybackComponent>();
 		for (auto [entity, transform, model, anim] : view.each()) {
 			if (!model.mesh().isSkinned) continue;
+			if (preSkinned && preSkinned->contains(entity)) continue;
 
 			glm::mat4 modelMatrix = transform.getMat4();
-			// NOTE: AABB cull skipped — the model-space AABB is the bind pose, not the deformed
-			// pose, so it can wrongly cull an animated mesh. A skinned-bounds pass is future work.
+			// Cull against the bounds of the pose actually drawn (baked per frame row, or written
+			// with the live palette) — never the bind-pose AABB, which a moving limb leaves.
+			glm::vec3 bMin, bMax;
+			if (model.frustumCull && anim.poseBounds(bMin, bMax) && !frustum.testAABB(bMin, bMax, modelMatrix))
+				continue;
 
-			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &model.mesh().vertexBuffer, offsets);
-			if (model.mesh().indexCount > 0)
-				vkCmdBindIndexBuffer(frameInfo.commandBuffer, model.mesh().indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+			SkinInstance inst{};
+			inst.modelMatrix     = modelMatrix;
+			inst.animBaseOffset  = anim.animBaseOffset();
+			inst.animNextOffset  = inst.animBaseOffset + anim.jointCount;
+			inst.animFrameBlend  = anim.frameBlend();
+			inst.materialRowBase = model.mesh().skinBase + model.skinIndex * model.mesh().numSlots;
+			batcher.add(&model.mesh(), inst);
+		}
+		const uint32_t dropped = batcher.upload(skinManager, BGLSkinManager::GBUFFER_INSTANCE_PASS);
+		if (dropped > 0 && !overflowLogged) {
+			CONSOLE->Log("Skin", "skinned instance budget full: " + std::to_string(dropped) +
+				" visible characters not drawn in the g-buffer pass");
+			overflowLogged = true;
+		}
+
+		SkinnedGBufferPushConstantData push{};
+		push.fallbackAlbedoMap = frameInfo.fallbackAlbedoMap;
+		for (const SkinInstanceBatcher::Batch& batch : batcher.batches()) {
+			const Model& mesh = *batch.model;
+			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &mesh.vertexBuffer, offsets);
+			if (mesh.indexCount > 0)
+				vkCmdBindIndexBuffer(frameInfo.commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-			SkinnedGBufferPushConstantData push{};
-			push.modelMatrix       = modelMatrix;
-			push.scale             = glm::vec4{ transform.getWorldScale(), 1.0f };
-			push.skinVertexBase    = model.mesh().skinVertexBase;
-			push.animBaseOffset    = anim.animBaseOffset();
-			push.materialRowBase   = model.mesh().skinBase + model.skinIndex * model.mesh().numSlots;
-			push.fallbackAlbedoMap = frameInfo.fallbackAlbedoMap;
+			push.skinVertexBase = mesh.skinVertexBase;
 			vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
 				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0, sizeof(SkinnedGBufferPushConstantData), &push);
 
 			// Solid submeshes only — transparent skinned submeshes are out of scope for now.
-			for (const ModelComponent::Submesh& sm : model.solidSubmeshes()) {
-				if (model.mesh().indexCount > 0)
-					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, 1, sm.firstIndex, 0, 0);
+			for (const Model::Submesh& sm : mesh.solidSubmeshes()) {
+				if (mesh.indexCount > 0)
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, batch.instanceCount, sm.firstIndex, 0, batch.firstInstance);
 				else
-					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, 1, sm.firstVertex, 0);
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, batch.instanceCount, sm.firstVertex, batch.firstInstance);
 			}
 		}
 	}
@@ -7,38 +7,45 @@
 #include "bagel_frame_info.hpp"
 #include "bagel_render_system.hpp"
 #include "engine/bagel_descriptors.hpp"
+#include "animation/bagel_skin_manager.hpp"
 
 namespace bagel {
 
-	// Push layout is binary-compatible with GBufferPushConstantData: the two buffered-transform
-	// slots (offsets 80/84) are repurposed as skinVertexBase/animBaseOffset, so this pass reuses
-	// gbuffer_fill.frag — only the vertex shader (skinned_gbuffer.vert) differs.
+	struct PreSkinnedFrame;
+
+	// Push layout shares gbuffer_fill.frag's push block, which reads emissionLux/fallbackAlbedoMap at
+	// 92/96. Model matrix, palette rows, frame blend and material are per instance (SkinInstance),
+	// so the first 80 bytes and the two slots after skinVertexBase carry nothing.
 	struct SkinnedGBufferPushConstantData {
-		glm::mat4 modelMatrix{ 1.0f };
-		glm::vec4 scale{ 1.0f };
-		uint32_t  skinVertexBase    = 0; // base into the per-vertex skin-influence SSBO
-		uint32_t  animBaseOffset    = 0; // base into the joint palette SSBO for this frame
-		uint32_t  materialRowBase   = 0; // skinBase + skinIndex*numSlots
-		float     emissionLux       = 1.0f;
-		uint32_t  fallbackAlbedoMap = 0;
+		uint8_t   _fragLayout[80]{};         // modelMatrix + scale in the static layout
+		uint32_t  skinVertexBase    = 0;     // base into the per-vertex skin-influence SSBO (80)
+		uint32_t  _unused[2]{};              // 84/88
+		float     emissionLux       = 1.0f;  // 92
+		uint32_t  fallbackAlbedoMap = 0;     // 96
 	};
 
 	// Deferred pass for skeletally-animated models. Draws into the SAME G-buffer as the static
-	// GBufferRenderSystem (shared render pass), per-entity (no buffered/instanced transform),
-	// reading the skin-influence + joint-palette SSBOs. Advances each entity's animation time.
+	// GBufferRenderSystem (shared render pass), reading the skin-influence + joint-palette SSBOs.
+	// Visible entities are grouped by Model and each group is one instanced draw per submesh, so a
+	// crowd of one character costs a handful of draws however many instances it has.
 	class AnimatedGBufferRenderSystem : BGLRenderSystem {
 	public:
 		AnimatedGBufferRenderSystem(
 			VkRenderPass renderPass,
 			std::vector<VkDescriptorSetLayout> setLayouts,
 			std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
+			BGLSkinManager& _skinManager,
 			entt::registry& _registry);
 
-		void renderEntities(FrameInfo& frameInfo);
+		// Entities in `preSkinned` (compute pre-skinning) are drawn by GBufferRenderSystem instead.
+		void renderEntities(FrameInfo& frameInfo, const PreSkinnedFrame* preSkinned = nullptr);
 
 	private:
 		entt::registry& registry;
 		std::unique_ptr<BGLBindlessDescriptorManager> const& descriptorManager;
+		BGLSkinManager& skinManager;
+		SkinInstanceBatcher batcher;
+		bool overflowLogged = false; // the instance budget overflow is reported once
 	};
 
 } // namespace bagel
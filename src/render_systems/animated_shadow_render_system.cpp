@@ -6,8 +6,11 @@
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
+#include "math/bagel_math.hpp"
 #include "ecs/components/model.hpp"
 #include "ecs/components/transform.hpp"
+#include "compute_systems/skinning_compute_system.hpp"
+#include "imgui/bagel_imgui.hpp"
 
 namespace bagel {
 
@@ -15,10 +18,12 @@ namespace bagel {
 		VkRenderPass renderPass,
 		std::vector<VkDescriptorSetLayout> setLayouts,
 		std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
+		BGLSkinManager& _skinManager,
 		entt::registry& _registry)
 		: BGLRenderSystem{ renderPass, setLayouts, sizeof(SkinnedShadowPushData) }
 		, registry{ _registry }
 		, descriptorManager{ _descriptorManager }
+		, skinManager{ _skinManager }
 	{
 		std::cout << "Creating Skinned Shadow Render System\n";
 		// Reuses the depth-only shadow fragment shader + shadow-map pipeline config.
@@ -28,7 +33,8 @@ namespace bagel {
 			BGLPipeline::setupShadowMapPipeline);
 	}
 
-	void AnimatedShadowRenderSystem::renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex)
+	void AnimatedShadowRenderSystem::renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP,
+		const PreSkinnedFrame* preSkinned)
 	{
 		bglPipeline->bind(frameInfo.commandBuffer);
 		vkCmdBindDescriptorSets(
@@ -41,33 +47,57 @@ namespace bagel {
 
 		VkDeviceSize offsets[] = { 0 };
 
+		// Same per-cascade caster cull as ShadowRenderSystem, on the animated pose bounds.
+		Frustum cascadeFrustum;
+		cascadeFrustum.extractFromVP(lightVP);
+
 		// Only the hot AnimationPlaybackComponent is needed (animBaseOffset() reads its cached
 		// scalars). Animation time is advanced once per frame in the engine loop; read-only here so
 		// the shadow pose matches the g-buffer pose exactly.
+		batcher.clear();
 		auto view = registry.view<TransformComponent, ModelComponent, AnimationPlaybackComponent>();
 		for (auto [entity, transform, model, anim] : view.each()) {
 			if (!model.mesh().isSkinned) continue;
+			if (preSkinned && preSkinned->contains(entity)) continue;
+			const glm::mat4 modelMatrix = transform.getMat4();
+			glm::vec3 bMin, bMax;
+			if (model.frustumCull && anim.poseBounds(bMin, bMax) && !cascadeFrustum.testAABB(bMin, bMax, modelMatrix))
+				continue;
+
+			SkinInstance inst{};
+			inst.modelMatrix    = modelMatrix;
+			inst.animBaseOffset = anim.animBaseOffset();
+			inst.animNextOffset = inst.animBaseOffset + anim.jointCount;
+			inst.animFrameBlend = anim.frameBlend();
+			batcher.add(&model.mesh(), inst);
+		}
+		const uint32_t dropped = batcher.upload(skinManager, BGLSkinManager::shadowInstancePass(cascadeIndex));
+		if (dropped > 0 && !overflowLogged) {
+			CONSOLE->Log("Skin", "skinned instance budget full: " + std::to_string(dropped) +
+				" casters not drawn in shadow cascade " + std::to_string(cascadeIndex));
+			overflowLogged = true;
+		}
 
-			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &model.mesh().vertexBuffer, offsets);
-			if (model.mesh().indexCount > 0)
-				vkCmdBindIndexBuffer(frameInfo.commandBuffer, model.mesh().indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+		SkinnedShadowPushData push{};
+		push.cascadeIndex = cascadeIndex;
+		for (const SkinInstanceBatcher::Batch& batch : batcher.batches()) {
+			const Model& mesh = *batch.model;
+			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &mesh.vertexBuffer, offsets);
+			if (mesh.indexCount > 0)
+				vkCmdBindIndexBuffer(frameInfo.commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-			SkinnedShadowPushData push{};
-			push.modelMatrix    = transform.getMat4();
-			push.skinVertexBase = model.mesh().skinVertexBase;
-			push.animBaseOffset = anim.animBaseOffset();
-			push.cascadeIndex   = cascadeIndex;
+			push.skinVertexBase = mesh.skinVertexBase;
 			vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
 				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0, sizeof(SkinnedShadowPushData), &push);
 
 			// Whole mesh casts (all submeshes, opaque depth).
-			for (uint32_t i = 0; i < model.mesh().submeshCount; i++) {
-				const Model::Submesh& sm = model.mesh().submeshes[i];
-				if (model.mesh().indexCount > 0)
-					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, 1, sm.firstIndex, 0, 0);
+			for (uint32_t i = 0; i < mesh.submeshCount; i++) {
+				const Model::Submesh& sm = mesh.submeshes[i];
+				if (mesh.indexCount > 0)
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, batch.instanceCount, sm.firstIndex, 0, batch.firstInstance);
 				else
-					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, 1, sm.firstVertex, 0);
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, batch.instanceCount, sm.firstVertex, batch.firstInstance);
 			}
 		}
 	}
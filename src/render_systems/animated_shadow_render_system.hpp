@@ -8,35 +8,43 @@
 #include "bagel_frame_info.hpp"
 #include "bagel_render_system.hpp"
 #include "engine/bagel_descriptors.hpp"
+#include "animation/bagel_skin_manager.hpp"
 
 namespace bagel {
 
-	// Push for the skinned shadow caster. Offsets 64/68 (the buffered-transform slots in the
-	// static ShadowPushData) are repurposed as skinVertexBase/animBaseOffset; cascadeIndex
-	// stays at 72, so this reuses shadow.frag and the shadow-map pipeline config.
+	struct PreSkinnedFrame;
+
+	// Push for the skinned shadow caster. shadow.frag reads no push constants, and everything per
+	// entity comes from the instance buffer (SkinInstance), so only the per-Model skin base and the
+	// cascade are pushed.
 	struct SkinnedShadowPushData {
-		glm::mat4 modelMatrix{ 1.0f };
-		uint32_t  skinVertexBase = 0;
-		uint32_t  animBaseOffset = 0;
-		uint32_t  cascadeIndex   = 0;
+		uint32_t skinVertexBase = 0;
+		uint32_t cascadeIndex   = 0;
 	};
 
 	// Renders skeletally-animated shadow casters into the shadow map with the SAME deformed
 	// pose the g-buffer pass uses, so the shadow silhouette tracks the animation instead of
-	// the bind pose. Runs alongside ShadowRenderSystem (which now skips skinned models).
+	// the bind pose. Runs alongside ShadowRenderSystem (which now skips skinned models). Instanced
+	// per Model like AnimatedGBufferRenderSystem; each cascade uploads its own culled set.
 	class AnimatedShadowRenderSystem : BGLRenderSystem {
 	public:
 		AnimatedShadowRenderSystem(
 			VkRenderPass renderPass,
 			std::vector<VkDescriptorSetLayout> setLayouts,
 			std::unique_ptr<BGLBindlessDescriptorManager> const& descriptorManager,
+			BGLSkinManager& skinManager,
 			entt::registry& registry);
 
-		void renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex);
+		// Entities in `preSkinned` (compute pre-skinning) are drawn by ShadowRenderSystem instead.
+		void renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP,
+			const PreSkinnedFrame* preSkinned = nullptr);
 
 	private:
 		entt::registry& registry;
 		std::unique_ptr<BGLBindlessDescriptorManager> const& descriptorManager;
+		BGLSkinManager& skinManager;
+		SkinInstanceBatcher batcher;
+		bool overflowLogged = false; // the instance budget overflow is reported once
 	};
 
 } // namespace bagel
@@ -9,6 +9,8 @@
 
 #include "planet/components/planet.hpp"
 #include "ecs/components/transform.hpp"
+#include "compute_systems/skinning_compute_system.hpp"
+#include "render_systems/instance_cull_system.hpp"
 
 namespace bagel {
 
@@ -35,7 +37,7 @@ namespace bagel {
 			0, sizeof(GBufferPushConstantData), &push);
 	}
 
-	void GBufferRenderSystem::renderEntities(FrameInfo& frameInfo)
+	void GBufferRenderSystem::renderEntities(FrameInfo& frameInfo, const VisibleInstanceFrame* visible)
 	{
 		const Frustum& frustum = frameInfo.cameraFrustum;
 
@@ -84,13 +86,22 @@ namespace bagel {
 		auto instancedGroup = registry.view<TransformArrayComponent, ModelComponent>();
 		for (auto [entity, transform, model] : instancedGroup.each()) {
 			if (model.mesh().isSkinned) continue; // skinned models are not instanced/buffered
+			// Culled batches draw their camera survivors out of the frame's visible-instance buffer.
+			uint32_t handle = transform.bufferHandle, firstInstance = 0, instanceCount = transform.count();
+			const VisibleInstanceBatch* batch = visible ? visible->find(entity) : nullptr;
+			if (batch && batch->camera.first != VisibleInstanceRange::UNCULLED) {
+				if (batch->camera.count == 0) continue;
+				handle        = visible->bufferHandle;
+				firstInstance = batch->camera.first;
+				instanceCount = batch->camera.count;
+			}
 			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &model.mesh().vertexBuffer, offsets);
 			if (model.mesh().indexCount > 0)
 				vkCmdBindIndexBuffer(frameInfo.commandBuffer, model.mesh().indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 			GBufferPushConstantData push{};
 			push.UsesBufferedTransform   = transform.useBuffer() ? 1 : 0;
-			push.BufferedTransformHandle = transform.bufferHandle;
+			push.BufferedTransformHandle = handle;
 			if (!transform.useBuffer()) {
 				push.modelMatrix = transform.mat4(0);
 				push.scale       = glm::vec4{ transform.getWorldScale(0), 1.0f };
@@ -100,9 +111,48 @@ namespace bagel {
 			// Solid submeshes only — transparent ones are drawn later in the forward pass.
 			for (const ModelComponent::Submesh& sm : model.solidSubmeshes()) {
 				if (model.mesh().indexCount > 0)
-					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, transform.count(), sm.firstIndex, 0, 0);
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, instanceCount, sm.firstIndex, 0, firstInstance);
+				else
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, instanceCount, sm.firstVertex, firstInstance);
+			}
+		}
+	}
+
+	void GBufferRenderSystem::renderPreSkinned(FrameInfo& frameInfo, const PreSkinnedFrame& preSkinned)
+	{
+		if (preSkinned.draws.empty()) return;
+
+		bglPipeline->bind(frameInfo.commandBuffer);
+		vkCmdBindDescriptorSets(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipelineLayout,
+			0, 1,
+			&frameInfo.globalDescriptorSets,
+			0, nullptr);
+
+		// Already culled against the pose bounds by the compute pass; the submesh AABBs are bind-pose
+		// and are not retested.
+		for (const PreSkinnedDraw& draw : preSkinned.draws) {
+			if (!draw.inCamera) continue;
+			const Model& mesh = *draw.mesh;
+			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &preSkinned.vertexBuffer, &draw.vertexOffset);
+			if (mesh.indexCount > 0)
+				vkCmdBindIndexBuffer(frameInfo.commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+			GBufferPushConstantData push{};
+			push.UsesBufferedTransform = 0;
+			push.modelMatrix       = draw.modelMatrix;
+			push.scale             = glm::vec4{ draw.worldScale, 1.0f };
+			push.fallbackAlbedoMap = frameInfo.fallbackAlbedoMap;
+			push.materialRowBase   = draw.materialRowBase;
+			SendGBufferPush(frameInfo.commandBuffer, pipelineLayout, push);
+			// Solid submeshes only, as in AnimatedGBufferRenderSystem.
+			for (const Model::Submesh& sm : mesh.solidSubmeshes()) {
+				if (mesh.indexCount > 0)
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, 1, sm.firstIndex, 0, 0);
 				else
-					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, transform.count(), sm.firstVertex, 0);
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, 1, sm.firstVertex, 0);
 			}
 		}
 	}
@@ -11,6 +11,9 @@
 
 namespace bagel {
 
+	struct PreSkinnedFrame;
+	struct VisibleInstanceFrame;
+
 	struct GBufferPushConstantData {
 		glm::mat4 modelMatrix{ 1.0f };
 		glm::vec4 scale{ 1.0f };
@@ -29,7 +32,12 @@ namespace bagel {
 			std::unique_ptr<BGLBindlessDescriptorManager> const& _descriptorManager,
 			entt::registry& _registry);
 
-		void renderEntities(FrameInfo& frameInfo);
+		// `visible`: this frame's per-instance culling (InstanceCullSystem). Instanced batches it
+		// culled draw only their camera survivors; the rest draw every instance.
+		void renderEntities(FrameInfo& frameInfo, const VisibleInstanceFrame* visible = nullptr);
+		// Camera-visible skinned entities that SkinningComputeSystem skinned this frame, drawn like
+		// static meshes from its vertex buffer.
+		void renderPreSkinned(FrameInfo& frameInfo, const PreSkinnedFrame& preSkinned);
 
 	private:
 		entt::registry& registry;
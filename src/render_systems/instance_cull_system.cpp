@@ -0,0 +1,91 @@
+#include "render_systems/instance_cull_system.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "bagel_worker_pool.hpp"
+#include "math/bagel_instance_cull.hpp"
+#include "ecs/components/model.hpp"
+#include "ecs/components/transform.hpp"
+
+namespace bagel {
+
+	static constexpr uint32_t INSTANCES_PER_CULL_CHUNK = 4096;
+
+	InstanceCullSystem::InstanceCullSystem(
+		BGLDevice& device,
+		std::unique_ptr<BGLBindlessDescriptorManager> const& descriptorManager,
+		entt::registry& _registry)
+		: registry{ _registry }
+	{
+		std::cout << "Creating Instance Cull System\n";
+		// One buffer per frame in flight, each in its own bindless slot: frame i only ever binds
+		// visibleHandles[i], so refilling it never races a frame still on the GPU.
+		for (int i = 0; i < BGLSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			visibleBuffers[i] = std::make_unique<BGLBuffer>(
+				device,
+				sizeof(TransformArrayComponent::TransformBufferUnit),
+				MAX_VISIBLE_INSTANCES,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			visibleBuffers[i]->map();
+			const std::string name = "VisibleInstances" + std::to_string(i);
+			visibleHandles[i] = descriptorManager->storeBuffer(visibleBuffers[i]->descriptorInfo(), name.c_str());
+		}
+	}
+
+	void InstanceCullSystem::cull(const FrameInfo& frameInfo, uint32_t frameIndex, const glm::mat4* cascadeVPs, uint32_t cascadeCount)
+	{
+		current.batches.clear();
+		current.instancesTotal = current.instancesInCamera = 0;
+		current.bufferHandle = visibleHandles[frameIndex];
+
+		// View 0 is the camera, view 1 + c is cascade c.
+		Frustum views[1 + SHADOW_CASCADE_COUNT];
+		views[0] = frameInfo.cameraFrustum;
+		cascadeCount = cascadeVPs ? std::min<uint32_t>(cascadeCount, SHADOW_CASCADE_COUNT) : 0;
+		for (uint32_t c = 0; c < cascadeCount; c++)
+			views[1 + c].extractFromVP(cascadeVPs[c]);
+		const uint32_t viewCount = 1 + cascadeCount;
+
+		BGLBuffer& buffer = *visibleBuffers[frameIndex];
+		glm::mat4* out = static_cast<glm::mat4*>(buffer.getMappedMemory());
+		uint32_t cursor = 0;
+
+		auto view = registry.view<TransformArrayComponent, ModelComponent>();
+		for (auto [entity, transform, model] : view.each()) {
+			if (model.mesh().isSkinned || !model.frustumCull || !transform.useBuffer()) continue;
+			const std::vector<glm::mat4>& matrices = transform.bufferedMatrices();
+			const uint32_t count = static_cast<uint32_t>(matrices.size());
+			if (count == 0) continue;
+
+			masks.resize(count);
+			const glm::vec3 bMin = model.mesh().aabbMin, bMax = model.mesh().aabbMax;
+			WorkerPool::get().parallelFor(count, INSTANCES_PER_CULL_CHUNK,
+				[&](uint32_t begin, uint32_t end, uint32_t) {
+					cullInstances(matrices.data(), bMin, bMax, views, viewCount, masks.data(), begin, end);
+				});
+
+			// Compact each view's survivors after the previous ones. A view that no longer fits
+			// keeps its range UNCULLED and draws the whole batch.
+			VisibleInstanceBatch batch{};
+			for (uint32_t v = 0; v < viewCount; v++) {
+				const size_t room = MAX_VISIBLE_INSTANCES - cursor;
+				const size_t survivors = compactInstances(matrices.data(), masks.data(), count,
+					static_cast<uint8_t>(1u << v), out + cursor, room);
+				if (survivors > room) continue;
+				VisibleInstanceRange& range = v == 0 ? batch.camera : batch.cascades[v - 1];
+				range.first = cursor;
+				range.count = static_cast<uint32_t>(survivors);
+				cursor += range.count;
+			}
+			current.instancesTotal    += count;
+			current.instancesInCamera += batch.camera.first == VisibleInstanceRange::UNCULLED ? count : batch.camera.count;
+			current.batches.emplace(entity, batch);
+		}
+		if (cursor > 0)
+			buffer.flush();
+	}
+
+} // namespace bagel
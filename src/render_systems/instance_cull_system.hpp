@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "entt.hpp"
+#include <glm/glm.hpp>
+
+#include "bagel_buffer.hpp"
+#include "bagel_frame_info.hpp"
+#include "engine/bagel_descriptors.hpp"
+
+namespace bagel {
+
+	// Where one view's surviving instances of a batch sit in VisibleInstanceFrame's buffer.
+	struct VisibleInstanceRange {
+		static constexpr uint32_t UNCULLED = ~0u;
+		uint32_t first = UNCULLED; // UNCULLED: not culled this frame, draw the batch's own buffer
+		uint32_t count = 0;
+	};
+
+	// One instanced entity's survivors: for the camera and for each shadow cascade.
+	struct VisibleInstanceBatch {
+		VisibleInstanceRange camera;
+		VisibleInstanceRange cascades[SHADOW_CASCADE_COUNT];
+	};
+
+	// What InstanceCullSystem produced this frame. The instanced draws of GBufferRenderSystem /
+	// ShadowRenderSystem read matrices from `bufferHandle` at firstInstance = range.first (the
+	// shaders index objects[gl_InstanceIndex], which includes it) instead of the batch's own buffer.
+	struct VisibleInstanceFrame {
+		uint32_t bufferHandle = 0;
+		std::unordered_map<entt::entity, VisibleInstanceBatch> batches;
+		uint32_t instancesTotal    = 0; // instances of the culled batches
+		uint32_t instancesInCamera = 0; // of those, how many the g-buffer draws
+
+		const VisibleInstanceBatch* find(entt::entity e) const
+		{
+			auto it = batches.find(e);
+			return it == batches.end() ? nullptr : &it->second;
+		}
+	};
+
+	// CPU per-instance culling for the instanced draw path (view<TransformArrayComponent,
+	// ModelComponent>). Each instance's mesh bounds are tested against the camera frustum and every
+	// shadow cascade, and each view's survivors are compacted into this frame's visible-instance
+	// buffer, so a large batch that is mostly off-screen costs what is visible. Batches that are not
+	// buffered, opt out of culling (ModelComponent::frustumCull) or overflow the per-frame budget
+	// are left out of the frame and drawn whole, as before.
+	class InstanceCullSystem {
+	public:
+		InstanceCullSystem(
+			BGLDevice& device,
+			std::unique_ptr<BGLBindlessDescriptorManager> const& descriptorManager,
+			entt::registry& registry);
+
+		InstanceCullSystem(const InstanceCullSystem&) = delete;
+		InstanceCullSystem& operator=(const InstanceCullSystem&) = delete;
+
+		// Cull every instanced batch for this frame. Must run after this frame's fence wait (the
+		// frame's buffer is rewritten) and before the shadow and g-buffer passes. `cascadeVPs` may be
+		// null (no directional light): cascade ranges then stay UNCULLED.
+		void cull(const FrameInfo& frameInfo, uint32_t frameIndex, const glm::mat4* cascadeVPs, uint32_t cascadeCount);
+
+		const VisibleInstanceFrame& frame() const { return current; }
+
+	private:
+		// Per frame in flight: 256k matrices * 64B = 16 MB of host-visible memory.
+		static constexpr uint32_t MAX_VISIBLE_INSTANCES = 1u << 18;
+
+		entt::registry& registry;
+		std::array<std::unique_ptr<BGLBuffer>, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> visibleBuffers;
+		std::array<uint32_t, BGLSwapChain::MAX_FRAMES_IN_FLIGHT> visibleHandles{};
+		std::vector<uint8_t> masks; // per-instance view bits of the batch being culled
+		VisibleInstanceFrame current;
+	};
+
+} // namespace bagel
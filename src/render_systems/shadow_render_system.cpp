@@ -8,6 +8,8 @@
 #include "math/bagel_math.hpp"
 #include "ecs/components/model.hpp"
 #include "ecs/components/transform.hpp"
+#include "compute_systems/skinning_compute_system.hpp"
+#include "render_systems/instance_cull_system.hpp"
 
 namespace bagel {
 
@@ -33,7 +35,8 @@ namespace bagel {
 			0, sizeof(ShadowPushData), &push);
 	}
 
-	void ShadowRenderSystem::renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP)
+	void ShadowRenderSystem::renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP,
+		const VisibleInstanceFrame* visible)
 	{
 		bglPipeline->bind(frameInfo.commandBuffer);
 		vkCmdBindDescriptorSets(
@@ -92,13 +95,23 @@ namespace bagel {
 		auto instancedGroup = registry.view<TransformArrayComponent, ModelComponent>();
 		for (auto [entity, transform, model] : instancedGroup.each()) {
 			if (model.mesh().isSkinned) continue; // skinned models are not instanced/buffered
+			uint32_t handle = transform.bufferHandle, firstInstance = 0, instanceCount = transform.count();
+			const VisibleInstanceBatch* batch = visible ? visible->find(entity) : nullptr;
+			if (batch && cascadeIndex < SHADOW_CASCADE_COUNT
+				&& batch->cascades[cascadeIndex].first != VisibleInstanceRange::UNCULLED) {
+				const VisibleInstanceRange& range = batch->cascades[cascadeIndex];
+				if (range.count == 0) continue;
+				handle        = visible->bufferHandle;
+				firstInstance = range.first;
+				instanceCount = range.count;
+			}
 			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &model.mesh().vertexBuffer, offsets);
 			if (model.mesh().indexCount > 0)
 				vkCmdBindIndexBuffer(frameInfo.commandBuffer, model.mesh().indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 			ShadowPushData push{};
 			push.UsesBufferedTransform   = transform.useBuffer() ? 1 : 0;
-			push.BufferedTransformHandle = transform.bufferHandle;
+			push.BufferedTransformHandle = handle;
 			push.cascadeIndex            = cascadeIndex;
 			if (!transform.useBuffer())
 				push.modelMatrix = transform.mat4(0);
@@ -108,9 +121,46 @@ namespace bagel {
 			for (uint32_t i = 0; i < model.mesh().solidSubmeshCount; i++) {
 				const Model::Submesh& sm = model.mesh().submeshes[i];
 				if (model.mesh().indexCount > 0)
-					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, transform.count(), sm.firstIndex, 0, 0);
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, instanceCount, sm.firstIndex, 0, firstInstance);
 				else
-					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, transform.count(), sm.firstVertex, 0);
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, instanceCount, sm.firstVertex, firstInstance);
+			}
+		}
+	}
+
+	void ShadowRenderSystem::renderPreSkinned(FrameInfo& frameInfo, uint32_t cascadeIndex, const PreSkinnedFrame& preSkinned)
+	{
+		if (preSkinned.draws.empty()) return;
+
+		bglPipeline->bind(frameInfo.commandBuffer);
+		vkCmdBindDescriptorSets(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipelineLayout,
+			0, 1,
+			&frameInfo.globalDescriptorSets,
+			0, nullptr);
+
+		for (const PreSkinnedDraw& draw : preSkinned.draws) {
+			if (!(draw.cascadeMask & (1u << cascadeIndex))) continue;
+			const Model& mesh = *draw.mesh;
+			vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, &preSkinned.vertexBuffer, &draw.vertexOffset);
+			if (mesh.indexCount > 0)
+				vkCmdBindIndexBuffer(frameInfo.commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+			ShadowPushData push{};
+			push.UsesBufferedTransform = 0;
+			push.modelMatrix           = draw.modelMatrix;
+			push.cascadeIndex          = cascadeIndex;
+			sendShadowPush(frameInfo.commandBuffer, pipelineLayout, push);
+
+			// Whole mesh casts, as in AnimatedShadowRenderSystem.
+			for (uint32_t i = 0; i < mesh.submeshCount; i++) {
+				const Model::Submesh& sm = mesh.submeshes[i];
+				if (mesh.indexCount > 0)
+					vkCmdDrawIndexed(frameInfo.commandBuffer, sm.indexCount, 1, sm.firstIndex, 0, 0);
+				else
+					vkCmdDraw(frameInfo.commandBuffer, sm.vertexCount, 1, sm.firstVertex, 0);
 			}
 		}
 	}
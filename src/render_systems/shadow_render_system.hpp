@@ -11,6 +11,9 @@
 
 namespace bagel {
 
+	struct PreSkinnedFrame;
+	struct VisibleInstanceFrame;
+
 	struct ShadowPushData {
 		glm::mat4 modelMatrix{ 1.0f };
 		uint32_t  BufferedTransformHandle = 0;
@@ -28,7 +31,11 @@ namespace bagel {
 
 		// lightVP is this cascade's light view-projection (ubo.directionalLight.lightSpaceMatrix[cascadeIndex]);
 		// used to frustum-cull casters that don't reach into this cascade's shadow volume.
-		void renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP);
+		// `visible`: instanced batches culled by InstanceCullSystem draw only this cascade's survivors.
+		void renderShadowCasters(FrameInfo& frameInfo, uint32_t cascadeIndex, const glm::mat4& lightVP,
+			const VisibleInstanceFrame* visible = nullptr);
+		// Compute pre-skinned casters that reach this cascade (PreSkinnedDraw::cascadeMask).
+		void renderPreSkinned(FrameInfo& frameInfo, uint32_t cascadeIndex, const PreSkinnedFrame& preSkinned);
 
 	private:
 		entt::registry& registry;